@@ -0,0 +1,172 @@
+/*
+Throughput of the digests over message sizes from 16 bytes to 1 GiB,
+with aligned and unaligned buffers, one message at a time or many
+messages at once with MD5MultiBuffer.
+
+Each line of the output is one measurement in CSV:
+algorithm,mode,kernel,size,offset,messages,seconds,mbps
+
+Options:
+--max-size BYTES  The largest message size (1 GiB by default)
+--min-time SECS   The least time of each measurement (0.2 by default)
+*/
+
+#include "jumble/md5.hpp"
+#include "jumble/md5_multi_buffer.hpp"
+#include "jumble/sha256.hpp"
+#include "jumble/xxhash.hpp"
+#include <chrono>
+#include <vector>
+#include <string>
+#include <memory>
+#include <utility>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cstddef>
+#include <cstdint>
+
+using jumble::MD5MultiBuffer;
+
+typedef std::size_t SizeType;
+
+namespace {
+
+// Offsets of the message from a 64-byte boundary
+const SizeType OFFSETS[] = {0, 1};
+
+// Messages hashed together by MD5MultiBuffer in one call
+const SizeType BATCH = 64;
+
+struct Options {
+    SizeType maxSize = (SizeType)1 << 30;
+    double minTime = 0.2;
+};
+
+double now() {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/*
+Run a function until the minimum time has passed.
+
+@param minTime The minimum time in seconds
+@param f       The function hashing some messages, returning their amount
+@return        The amount of messages hashed and the seconds taken
+*/
+template<typename Func>
+std::pair<SizeType, double> measure(const double minTime, Func f) {
+    SizeType messages = 0;
+    double start = now(), elapsed = 0;
+    do {
+        messages += f();
+        elapsed = now() - start;
+    } while (elapsed < minTime);
+    return {messages, elapsed};
+}
+
+void report(const char *algo, const char *mode, const char *kernel, const SizeType size,
+            const SizeType offset, const std::pair<SizeType, double>& res) {
+    double mbps = (double)res.first * (double)size / res.second / 1e6;
+    std::printf("%s,%s,%s,%zu,%zu,%zu,%.6f,%.2f\n", algo, mode, kernel, size, offset,
+                res.first, res.second, mbps);
+    std::fflush(stdout);
+}
+
+const char* kernelName(const MD5MultiBuffer::Kernel k) {
+    switch (k) {
+        case MD5MultiBuffer::SSE2:
+            return "sse2";
+        case MD5MultiBuffer::AVX2:
+            return "avx2";
+        case MD5MultiBuffer::AVX512:
+            return "avx512";
+        default:
+            return "scalar";
+    }
+}
+
+void benchSize(const Options& opts, const unsigned char *const base, const SizeType size) {
+    unsigned char digest[jumble::SHA256Context::DIGEST_SIZE];
+    volatile unsigned char sink = 0;
+    for (SizeType offset : OFFSETS) {
+        const unsigned char *msg = base + offset;
+        report("md5", "single", "scalar", size, offset, measure(opts.minTime, [&] {
+            jumble::MD5::hash(msg, size, digest);
+            sink = sink + digest[0];
+            return (SizeType)1;
+        }));
+
+        jumble::SHA256Context sha;
+        report("sha256", "single", sha.getKernel() == jumble::SHA256Context::SHANI ? "shani" : "portable",
+               size, offset, measure(opts.minTime, [&] {
+            sha.update(msg, size);
+            sha.finalize(digest);
+            sink = sink + digest[0];
+            return (SizeType)1;
+        }));
+
+        report("xxh64", "single", "scalar", size, offset, measure(opts.minTime, [&] {
+            sink = sink + (unsigned char)jumble::XXH64::hash(msg, size);
+            return (SizeType)1;
+        }));
+
+        // All messages of a batch share the buffer, so huge sizes fit in memory
+        for (auto k : {MD5MultiBuffer::SCALAR, MD5MultiBuffer::SSE2, MD5MultiBuffer::AVX2,
+                       MD5MultiBuffer::AVX512}) {
+            if (!MD5MultiBuffer::isSupported(k)) {
+                continue;
+            }
+            MD5MultiBuffer hasher(k);
+            SizeType batch = size >= ((SizeType)1 << 24) ? MD5MultiBuffer::getLaneCount(k) : BATCH;
+            std::vector<const void*> data(batch, msg);
+            std::vector<SizeType> lens(batch, size);
+            std::vector<unsigned char> digests(batch * MD5MultiBuffer::DIGEST_SIZE);
+            report("md5", "multi", kernelName(k), size, offset, measure(opts.minTime, [&] {
+                hasher.hash(data.data(), lens.data(), batch, digests.data());
+                sink = sink + digests[0];
+                return batch;
+            }));
+        }
+    }
+}
+
+bool parseOptions(const int argc, char **argv, Options& opts) {
+    for (int i = 1; i < argc; ++i) {
+        if (i + 1 < argc && std::strcmp(argv[i], "--max-size") == 0) {
+            opts.maxSize = (SizeType)std::strtoull(argv[++i], nullptr, 10);
+        } else if (i + 1 < argc && std::strcmp(argv[i], "--min-time") == 0) {
+            opts.minTime = std::strtod(argv[++i], nullptr);
+        } else {
+            return false;
+        }
+    }
+    return opts.maxSize >= 16;
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+    Options opts;
+    if (!parseOptions(argc, argv, opts)) {
+        std::fprintf(stderr, "usage: %s [--max-size BYTES] [--min-time SECS]\n", argv[0]);
+        return 1;
+    }
+
+    // One buffer for all sizes, aligned to 64 bytes with room for the offsets
+    std::unique_ptr<unsigned char[]> storage(new unsigned char[opts.maxSize + 128]);
+    unsigned char *base = storage.get() + (64 - (std::uintptr_t)storage.get() % 64);
+    std::uint64_t x = 0x9e3779b97f4a7c15ULL;
+    for (SizeType i = 0; i < opts.maxSize + 64; ++i) {
+        x ^= x << 13;
+        x ^= x >> 7;
+        x ^= x << 17;
+        base[i] = (unsigned char)x;
+    }
+
+    std::printf("algorithm,mode,kernel,size,offset,messages,seconds,mbps\n");
+    for (SizeType size = 16; size <= opts.maxSize; size *= 4) {
+        benchSize(opts, base, size);
+    }
+    return 0;
+}
@@ -0,0 +1,562 @@
+#ifndef JUMBLE_ASTAR_HPP_INCLUDED
+#define JUMBLE_ASTAR_HPP_INCLUDED
+
+#include "jumble/binary_heap.hpp"
+#include "jumble/bucket_queue.hpp"
+#include "jumble/util/arena.hpp"
+#include <vector>
+#include <memory>
+#include <functional>
+#include <algorithm>
+#include <utility>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+JUMBLE_NAMESPACE_BEGIN
+
+/*
+A node of A* search: a state reached from its parent, with the cost
+'g' from the start state and the estimated cost 'h' to a goal state.
+*/
+template<typename State>
+struct AStarNode {
+    using CostType = std::uint32_t;
+
+    State state;
+    AStarNode *parent;
+    CostType g;
+    CostType h;
+
+    CostType getF() const noexcept {
+        return g + h;
+    }
+};
+
+// Counters of one A* search
+struct AStarStats {
+    using SizeType = std::size_t;
+
+    SizeType expansions = 0;      // Nodes taken from the open list, including the goal
+    SizeType generations = 0;     // Successors emitted by the expansion function
+    SizeType duplicates = 0;      // Successors dropped since their states were reached with no larger cost
+    SizeType openPushes = 0;      // Operations on the open list
+    SizeType openPops = 0;        // Including nodes replaced by cheaper ones
+    SizeType peakOpen = 0;        // Peak amount of nodes in the open list
+    SizeType peakClosed = 0;      // Peak amount of states in the closed set
+    SizeType allocatedBytes = 0;  // Memory of the nodes allocated
+    SizeType peakBytes = 0;       // Peak memory of the nodes, open list and closed set
+    double seconds = 0;           // Time spent in the search
+
+    double expansionsPerSecond() const noexcept {
+        return seconds > 0 ? expansions / seconds : 0;
+    }
+
+    // Return the fraction of successors found in the closed set with no larger cost
+    double duplicateRate() const noexcept {
+        return generations ? (double)duplicates / generations : 0;
+    }
+};
+
+/*
+Open list policies of AStar. An open list keeps node pointers and must
+provide push(Node*), top(), pop(), isEmpty(), getSize(), clear() and
+getBytes(), the approximate amount of memory it holds.
+*/
+
+// An open list of a binary heap ordered by f and then h
+template<typename Node>
+class HeapOpenList {
+public:
+    using SizeType = std::size_t;
+
+    SizeType getSize() const noexcept {
+        return heap.getSize();
+    }
+
+    bool isEmpty() const noexcept {
+        return heap.isEmpty();
+    }
+
+    void clear() noexcept {
+        heap.clear();
+    }
+
+    void push(Node *const n) {
+        heap.push(n);
+    }
+
+    Node* top() const {
+        return heap.top();
+    }
+
+    void pop() {
+        heap.pop();
+    }
+
+    SizeType getBytes() const noexcept {
+        return heap.getSize() * sizeof(Node*);
+    }
+
+private:
+    struct Less {
+        bool operator()(const Node *const &n1, const Node *const &n2) const noexcept {
+            return n1->getF() < n2->getF() || (n1->getF() == n2->getF() && n1->h < n2->h);
+        }
+    };
+
+    BinaryHeap<Node*, Less> heap;
+};
+
+/*
+An open list of buckets indexed by f and then h, see BucketQueue.
+Only suitable for small integer costs.
+*/
+template<typename Node>
+class BucketOpenList {
+public:
+    using SizeType = std::size_t;
+
+    SizeType getSize() const noexcept {
+        return queue.getSize();
+    }
+
+    bool isEmpty() const noexcept {
+        return queue.isEmpty();
+    }
+
+    void clear() noexcept {
+        queue.clear();
+    }
+
+    void push(Node *const n) {
+        queue.push(n, n->getF(), n->h);
+    }
+
+    Node* top() const {
+        return queue.top();
+    }
+
+    void pop() {
+        queue.pop();
+    }
+
+    SizeType getBytes() const noexcept {
+        return queue.getSize() * sizeof(Node*);
+    }
+
+private:
+    BucketQueue<Node*> queue;
+};
+
+/*
+Closed set policies of AStar. A closed set maps each state reached so
+far to its node with the smallest g, and must provide insert(Node*),
+replace(Node*), find(const State&), getSize(), clear() and getBytes().
+
+HashClosedSet is an open addressing hash table with linear probing.
+Each slot keeps the hash value next to the node pointer, so probing and
+rehashing never touch the nodes of other states. Hash values are mixed
+by Fibonacci hashing, so weak hash functions (e.g. identity) are fine.
+*/
+template<typename Node, typename Hash, typename Equal>
+class HashClosedSet {
+public:
+    using SizeType = std::size_t;
+    using State = decltype(std::declval<Node>().state);
+
+    explicit HashClosedSet(Hash hash_ = Hash(), Equal equal_ = Equal())
+        : hash(std::move(hash_)), equal(std::move(equal_)) {}
+
+    SizeType getSize() const noexcept {
+        return size;
+    }
+
+    // Remove all nodes. The table keeps its memory.
+    void clear() noexcept {
+        if (size) {
+            std::fill(slots.begin(), slots.end(), Slot());
+            size = 0;
+        }
+    }
+
+    /*
+    Insert a node unless its state is already in the set.
+
+    @param n The node
+    @return  The node with the same state in the set, or nullptr
+             if the node is inserted
+    */
+    Node* insert(Node *const n) {
+        if ((size + 1) * 2 > slots.size()) {
+            grow();
+        }
+        SizeType h = hash(n->state);
+        Slot &s = slots[locate(n->state, h)];
+        if (s.node) {
+            return s.node;
+        }
+        s.node = n;
+        s.hash = h;
+        ++size;
+        return nullptr;
+    }
+
+    /*
+    Replace the node with the same state as a given node.
+    Precondition: a node with the same state is in the set.
+    */
+    void replace(Node *const n) {
+        slots[locate(n->state, hash(n->state))].node = n;
+    }
+
+    // Return the node of a given state, or nullptr if it is not in the set
+    Node* find(const State& state) const {
+        return size ? slots[locate(state, hash(state))].node : nullptr;
+    }
+
+    SizeType getBytes() const noexcept {
+        return slots.size() * sizeof(Slot);
+    }
+
+private:
+    struct Slot {
+        Node *node = nullptr;
+        SizeType hash = 0;
+    };
+
+    static const SizeType MIN_CAPACITY = 1024;
+
+    SizeType index(const SizeType h) const noexcept {
+        return (SizeType)(((std::uint64_t)h * 0x9e3779b97f4a7c15ULL) >> shift);
+    }
+
+    /*
+    Return the slot of a given state, or the empty slot ending its probe
+    sequence if the state is not in the set.
+    Precondition: the table is allocated
+
+    @param state The state
+    @param h     The hash value of the state
+    */
+    SizeType locate(const State& state, const SizeType h) const {
+        SizeType i = index(h);
+        while (slots[i].node && !(slots[i].hash == h && equal(slots[i].node->state, state))) {
+            i = (i + 1) & (slots.size() - 1);
+        }
+        return i;
+    }
+
+    // Double the capacity and rehash the nodes
+    void grow() {
+        std::vector<Slot> old(std::max(slots.size() * 2, (SizeType)MIN_CAPACITY));
+        old.swap(slots);
+        shift = 64;
+        for (SizeType c = slots.size(); c > 1; c >>= 1) {
+            --shift;
+        }
+        for (const Slot &s : old) {
+            if (s.node) {
+                SizeType i = index(s.hash);
+                while (slots[i].node) {
+                    i = (i + 1) & (slots.size() - 1);
+                }
+                slots[i] = s;
+            }
+        }
+    }
+
+private:
+    Hash hash;
+    Equal equal;
+    std::vector<Slot> slots;  // The capacity is a power of two
+    SizeType size = 0;
+    unsigned shift = 64;  // 64 - log2(capacity)
+};
+
+/*
+Allocator policies of AStar. An allocator must provide create(const Node&),
+destroy(Node*) for the node created last, reset() freeing all nodes, and
+getBytes(), the amount of memory held by the nodes.
+*/
+
+/*
+Nodes placed in an arena, freed all at once by reset() with no call to
+the system allocator. The state type must be trivially destructible.
+*/
+template<typename Node>
+class ArenaAllocator {
+public:
+    using SizeType = std::size_t;
+
+    Node* create(const Node& n) {
+        return arena.create<Node>(n);
+    }
+
+    void destroy(Node *const n) noexcept {
+        arena.deallocate(n, sizeof(Node));
+    }
+
+    void reset() noexcept {
+        arena.reset();
+    }
+
+    SizeType getBytes() const noexcept {
+        return arena.getUsedBytes();
+    }
+
+private:
+    Arena arena;
+};
+
+// Nodes allocated one by one from the system allocator, for any state type
+template<typename Node>
+class SystemAllocator {
+public:
+    using SizeType = std::size_t;
+
+    Node* create(const Node& n) {
+        nodes.emplace_back(new Node(n));
+        return nodes.back().get();
+    }
+
+    void destroy(Node *const n) noexcept {
+        if (!nodes.empty() && nodes.back().get() == n) {
+            nodes.pop_back();
+        }
+    }
+
+    void reset() noexcept {
+        nodes.clear();
+    }
+
+    SizeType getBytes() const noexcept {
+        return nodes.size() * sizeof(Node);
+    }
+
+private:
+    std::vector<std::unique_ptr<Node>> nodes;
+};
+
+/*
+A* search over an implicit graph of states. The graph is given by an
+expansion function instead of being stored, so one engine serves every
+search problem: sliding puzzles, grid maps, planning, and so on.
+
+A state reached again with a smaller cost replaces its old node, which
+is skipped when it leaves the open list, so paths are shortest as long
+as the heuristic is admissible, even if it is not consistent.
+
+@param State     The type of states. It must be copyable.
+@param Expand    A function object called as expand(state, emit), which calls
+                 emit(nextState, cost) for each successor of 'state'
+@param Heuristic A function object returning the estimated cost (CostType)
+                 from a state to a goal state
+@param Hash      A function object returning the hash value of a state
+@param Equal     A function object returning true if two states are equal
+@param OpenList  The open list policy, e.g. HeapOpenList or BucketOpenList
+@param ClosedSet The closed set policy, e.g. HashClosedSet
+@param Allocator The node allocator policy, e.g. ArenaAllocator or SystemAllocator
+*/
+template<typename State,
+         typename Expand,
+         typename Heuristic,
+         typename Hash = std::hash<State>,
+         typename Equal = std::equal_to<State>,
+         template<typename> class OpenList = HeapOpenList,
+         template<typename, typename, typename> class ClosedSet = HashClosedSet,
+         template<typename> class Allocator = ArenaAllocator>
+class AStar {
+public:
+    using Node = AStarNode<State>;
+    using CostType = typename Node::CostType;
+    using SizeType = std::size_t;
+
+    using Stats = AStarStats;
+
+    // A function called with the counters during a search
+    using Progress = std::function<void(const Stats&)>;
+
+    /*
+    Initialize the engine.
+
+    @param expand_    The expansion function
+    @param heuristic_ The heuristic function
+    @param hash_      The hash function
+    @param equal_     The equality function
+    */
+    explicit AStar(Expand expand_ = Expand(), Heuristic heuristic_ = Heuristic(),
+                   Hash hash_ = Hash(), Equal equal_ = Equal())
+        : expand(std::move(expand_)), heuristic(std::move(heuristic_)), equal(equal_),
+          closed(std::move(hash_), std::move(equal_)) {}
+
+    // Forbid copy, the nodes point into the allocator
+    AStar(const AStar&) = delete;
+    AStar& operator=(const AStar&) = delete;
+
+    /*
+    Search a path from a start state to a goal state.
+
+    @param start The start state
+    @param goal  The goal state
+    @return      True if a path is found
+    */
+    bool search(const State& start, const State& goal) {
+        return search(start, [this, &goal](const State& s) {
+            return equal(s, goal);
+        });
+    }
+
+    /*
+    Search a path from a start state to any goal state. The nodes of the
+    last search are kept until the next one, so getPath() stays valid.
+
+    @param start  The start state
+    @param isGoal A function returning true for goal states
+    @return       True if a path is found
+    */
+    template<typename IsGoal>
+    bool search(const State& start, IsGoal isGoal) {
+        clear();
+        startTime = std::chrono::steady_clock::now();
+        SizeType countdown = progressInterval;
+        Node *first = alloc.create(Node{start, nullptr, 0, heuristic(start)});
+        closed.insert(first);
+        open.push(first);
+        ++stats.openPushes;
+        while (!open.isEmpty()) {
+            Node *cur = open.top();
+            open.pop();
+            ++stats.openPops;
+            if (closed.find(cur->state) != cur) {
+                continue;  // Reached again with a smaller cost
+            }
+            ++stats.expansions;
+            if (isGoal(cur->state)) {
+                goal = cur;
+                break;
+            }
+            expand(cur->state, [this, cur](const State& next, const CostType cost) {
+                generate(cur, next, cost);
+            });
+            stats.peakOpen = std::max(stats.peakOpen, open.getSize());
+            stats.peakBytes = std::max(stats.peakBytes, getBytes());
+            if (countdown && --countdown == 0) {
+                countdown = progressInterval;
+                updateStats();
+                progress(stats);
+            }
+        }
+        updateStats();
+        return goal != nullptr;
+    }
+
+    // Return the goal node of the last search, or nullptr if no path is found
+    const Node* getGoal() const noexcept {
+        return goal;
+    }
+
+    // Return the cost of the path found by the last search
+    CostType getCost() const noexcept {
+        return goal ? goal->g : 0;
+    }
+
+    // Return the states from the start state to the goal state, empty if no path is found
+    std::vector<State> getPath() const {
+        std::vector<State> res;
+        for (const Node *n = goal; n; n = n->parent) {
+            res.push_back(n->state);
+        }
+        std::reverse(res.begin(), res.end());
+        return res;
+    }
+
+    // Return the counters of the last search
+    const Stats& getStats() const noexcept {
+        return stats;
+    }
+
+    /*
+    Report the counters periodically during searches.
+
+    @param progress_ The function called with the counters
+    @param interval  The amount of expansions between two calls,
+                     zero or an empty function to stop reporting
+    */
+    void setProgress(Progress progress_, const SizeType interval) {
+        progress = std::move(progress_);
+        progressInterval = progress ? interval : 0;
+    }
+
+    // Return the expansion function, to update its data between searches
+    Expand& getExpand() noexcept {
+        return expand;
+    }
+
+    // Return the heuristic function, to update its data between searches
+    Heuristic& getHeuristic() noexcept {
+        return heuristic;
+    }
+
+    // Free the nodes of the last search, keeping the memory for the next one
+    void clear() {
+        open.clear();
+        closed.clear();
+        alloc.reset();
+        goal = nullptr;
+        stats = Stats();
+    }
+
+private:
+    // Handle a successor of a node
+    void generate(Node *const cur, const State& next, const CostType cost) {
+        ++stats.generations;
+        Node *n = alloc.create(Node{next, cur, cur->g + cost, 0});
+        Node *old = closed.insert(n);
+        if (old) {
+            if (n->g >= old->g) {
+                ++stats.duplicates;
+                alloc.destroy(n);
+                return;
+            }
+            n->h = old->h;
+            closed.replace(n);
+        } else {
+            n->h = heuristic(n->state);
+        }
+        open.push(n);
+        ++stats.openPushes;
+    }
+
+    // Update the counters not maintained during the search
+    void updateStats() {
+        stats.peakClosed = closed.getSize();  // States are never removed
+        stats.allocatedBytes = alloc.getBytes();
+        stats.peakBytes = std::max(stats.peakBytes, getBytes());
+        stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    }
+
+    SizeType getBytes() const noexcept {
+        return alloc.getBytes() + open.getBytes() + closed.getBytes();
+    }
+
+private:
+    Expand expand;
+    Heuristic heuristic;
+    Equal equal;
+
+    OpenList<Node> open;
+    ClosedSet<Node, Hash, Equal> closed;
+    Allocator<Node> alloc;
+
+    const Node *goal = nullptr;
+    Stats stats;
+    std::chrono::steady_clock::time_point startTime;
+
+    Progress progress;
+    SizeType progressInterval = 0;
+};
+
+JUMBLE_NAMESPACE_END
+
+#endif
@@ -0,0 +1,132 @@
+#ifndef JUMBLE_BUCKET_QUEUE_HPP_INCLUDED
+#define JUMBLE_BUCKET_QUEUE_HPP_INCLUDED
+
+#include "jumble/util/common.hpp"
+#include <vector>
+#include <limits>
+#include <cstddef>
+
+JUMBLE_NAMESPACE_BEGIN
+
+/*
+A priority queue for small integer priorities, such as the f values of
+A* search with unit costs. Values are kept in buckets indexed by their
+primary key and then by their secondary key, so push() and pop() take
+O(1) time plus skipping empty buckets, instead of O(log n) comparisons.
+
+The top value has the smallest primary key, then the smallest secondary
+key. Values with equal keys are returned in LIFO order. For A* the keys
+are f and h: among nodes with the same f, the deepest one comes first.
+
+@param Value The type of the values stored in the queue
+*/
+template<typename Value>
+class BucketQueue {
+public:
+    using SizeType = std::size_t;
+
+    // Return the amount of elements in the queue
+    SizeType getSize() const noexcept {
+        return size;
+    }
+
+    // Return true if the queue has no elements
+    bool isEmpty() const noexcept {
+        return size == 0;
+    }
+
+    // Remove all elements. The buckets keep their memory.
+    void clear() noexcept {
+        for (auto &level : levels) {
+            if (level.size) {
+                for (auto &bucket : level.buckets) {
+                    bucket.clear();
+                }
+                level.size = 0;
+                level.minKey = NONE;
+            }
+        }
+        size = 0;
+        minKey = NONE;
+    }
+
+    /*
+    Insert a new element to the queue.
+
+    @param val    The element
+    @param key1   The primary key
+    @param key2   The secondary key
+    */
+    void push(const Value& val, const SizeType key1, const SizeType key2 = 0) {
+        if (key1 >= levels.size()) {
+            levels.resize(key1 + 1);
+        }
+        Level &level = levels[key1];
+        if (key2 >= level.buckets.size()) {
+            level.buckets.resize(key2 + 1);
+        }
+        level.buckets[key2].push_back(val);
+        ++level.size;
+        if (key2 < level.minKey) {
+            level.minKey = key2;
+        }
+        ++size;
+        if (key1 < minKey) {
+            minKey = key1;
+        }
+    }
+
+    /*
+    Return the element with the smallest keys.
+    Precondition: The queue is non-empty.
+    */
+    const Value& top() const {
+        const Level &level = levels[minKey];
+        return level.buckets[level.minKey].back();
+    }
+
+    /*
+    Remove the element with the smallest keys.
+    Precondition: The queue is non-empty.
+    */
+    void pop() {
+        Level &level = levels[minKey];
+        level.buckets[level.minKey].pop_back();
+        --size;
+        if (--level.size == 0) {
+            level.minKey = NONE;
+            if (size == 0) {
+                minKey = NONE;
+            } else {
+                while (levels[minKey].size == 0) {
+                    ++minKey;
+                }
+            }
+        } else {
+            while (level.buckets[level.minKey].empty()) {
+                ++level.minKey;
+            }
+        }
+    }
+
+private:
+    static constexpr SizeType NONE = std::numeric_limits<SizeType>::max();
+
+    // The buckets with the same primary key
+    struct Level {
+        std::vector<std::vector<Value>> buckets;  // Indexed by the secondary key
+        SizeType size = 0;
+        SizeType minKey = NONE;  // The smallest secondary key in use
+    };
+
+    SizeType size = 0;
+    SizeType minKey = NONE;  // The smallest primary key in use
+    std::vector<Level> levels;
+};
+
+template<typename Value>
+constexpr typename BucketQueue<Value>::SizeType BucketQueue<Value>::NONE;
+
+JUMBLE_NAMESPACE_END
+
+#endif
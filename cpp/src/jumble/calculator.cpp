@@ -1,11 +1,62 @@
 #include "jumble/calculator.hpp"
 #include <stdexcept>
-#include <stack>
-#include <cstddef>
+#include <algorithm>
+#include <cstdint>
 #include <cctype>
 
 JUMBLE_NAMESPACE_BEGIN
 
+namespace {
+
+/*
+Checked 64-bit arithmetic shared by the evaluators. A result out of the
+range of std::int64_t would be undefined behavior, so it throws instead.
+
+@throw std::runtime_error if the result overflows, or on division by zero
+*/
+std::int64_t checkedNeg(const std::int64_t val) {
+    if (val == INT64_MIN) {
+        throw std::runtime_error("overflow");
+    }
+    return -val;
+}
+
+std::int64_t checkedAdd(const std::int64_t lhs, const std::int64_t rhs) {
+    std::int64_t res;
+    if (__builtin_add_overflow(lhs, rhs, &res)) {
+        throw std::runtime_error("overflow");
+    }
+    return res;
+}
+
+std::int64_t checkedSub(const std::int64_t lhs, const std::int64_t rhs) {
+    std::int64_t res;
+    if (__builtin_sub_overflow(lhs, rhs, &res)) {
+        throw std::runtime_error("overflow");
+    }
+    return res;
+}
+
+std::int64_t checkedMul(const std::int64_t lhs, const std::int64_t rhs) {
+    std::int64_t res;
+    if (__builtin_mul_overflow(lhs, rhs, &res)) {
+        throw std::runtime_error("overflow");
+    }
+    return res;
+}
+
+std::int64_t checkedDiv(const std::int64_t lhs, const std::int64_t rhs) {
+    if (rhs == 0) {
+        throw std::runtime_error("division by zero");
+    }
+    if (rhs == -1 && lhs == INT64_MIN) {
+        throw std::runtime_error("overflow");
+    }
+    return lhs / rhs;
+}
+
+}  // namespace
+
 // Lexer
 
 Token Lexer::scan() {
@@ -20,14 +71,33 @@ Token Lexer::scan() {
     }
 
     if (isdigit(cur)) {
-        std::size_t val = 0;
+        std::int64_t val = 0;
         do {
-            val = 10 * val + (cur - '0');
+            int digit = cur - '0';
+            if (val > (INT64_MAX - digit) / 10) {
+                throw std::runtime_error("number out of range");
+            }
+            val = 10 * val + digit;
         } while (is.get(cur) && isdigit(cur));
-        return Token::num(std::to_string(val));
+        return Token::num(val);
+    }
+
+    if (isalpha(cur) || cur == '_') {
+        name.clear();
+        do {
+            name.push_back(cur);
+        } while (is.get(cur) && (isalnum(cur) || cur == '_'));
+        std::size_t i = 0;
+        while (i < names.size() && names[i] != name) {
+            ++i;
+        }
+        if (i == names.size()) {
+            names.push_back(name);
+        }
+        return Token::var(i);
     }
 
-    auto tok = Token::oper(std::string(1, cur));
+    auto tok = Token::oper(Token::Op(cur));
     cur = ' ';
     return tok;
 }
@@ -35,17 +105,19 @@ Token Lexer::scan() {
 // Parser
 
 const std::vector<Token>& Parser::parse() {
+    postfix.clear();
+    lexer.reset();
     read();
     expr();
 
     if (cur.type() != Token::END_INPUT) {
-        auto val = cur.val();
+        auto val = text(cur);
         while (true) {
             read();
             if (cur.type() == Token::END_INPUT) {
                 break;
             }
-            val +=  " " + cur.val();
+            val +=  " " + text(cur);
         }
         throw std::runtime_error("cannot parse " + val);
     }
@@ -53,15 +125,67 @@ const std::vector<Token>& Parser::parse() {
     return postfix;
 }
 
+CompiledExpr Parser::compile() {
+    const auto &toks = parse();
+
+    CompiledExpr res;
+    res.vars = lexer.getNames();
+    std::size_t depth = 0, maxDepth = 0;
+    for (const auto &tok : toks) {
+        CompiledExpr::Instr instr = {CompiledExpr::CONST, 0};
+        if (tok.type() == Token::NUMBER) {
+            instr.arg = (std::uint32_t)res.consts.size();
+            res.consts.push_back(tok.number());
+            ++depth;
+        } else if (tok.type() == Token::VARIABLE) {
+            instr = {CompiledExpr::LOAD, (std::uint32_t)tok.var()};
+            ++depth;
+        } else {
+            switch (tok.op()) {
+                case Token::POS:
+                    continue;
+                case Token::NEG:
+                    instr.op = CompiledExpr::NEG;
+                    break;
+                case Token::ADD:
+                    instr.op = CompiledExpr::ADD;
+                    break;
+                case Token::SUB:
+                    instr.op = CompiledExpr::SUB;
+                    break;
+                case Token::MUL:
+                    instr.op = CompiledExpr::MUL;
+                    break;
+                case Token::DIV:
+                    instr.op = CompiledExpr::DIV;
+                    break;
+                default:
+                    throw std::runtime_error("unknown operator " + tok.str());
+            }
+            if (instr.op != CompiledExpr::NEG) {
+                --depth;
+            }
+        }
+        res.code.push_back(instr);
+        maxDepth = std::max(maxDepth, depth);
+    }
+    res.stack.resize(maxDepth);
+    return res;
+}
+
+std::string Parser::text(const Token& tok) const {
+    return tok.type() == Token::VARIABLE ? lexer.getNames()[tok.var()] : tok.str();
+}
+
 void Parser::expr() {
     switch (cur.type()) {
         case Token::END_INPUT:
-            throw std::runtime_error("expr meets " + cur.val());
+            throw std::runtime_error("expr meets " + text(cur));
             break;
         case Token::OPERATOR: {
-            auto val = cur.val();
-            if (val == "*" || val == "/" || val == ")") {
-                throw std::runtime_error("expr meets operator " + val);
+            auto op = cur.op();
+            if (op == Token::MUL || op == Token::DIV || op == Token::RIGHT) {
+                throw std::runtime_error("expr meets operator " + text(cur));
             }
             break;
         }
@@ -75,12 +199,12 @@ void Parser::expr() {
 void Parser::A() {
     switch (cur.type()) {
         case Token::END_INPUT:
-            throw std::runtime_error("A meets " + cur.val());
+            throw std::runtime_error("A meets " + text(cur));
             break;
         case Token::OPERATOR: {
-            auto val = cur.val();
-            if (val == "*" || val == "/" || val == ")") {
-                throw std::runtime_error("A meets operator " + val);
+            auto op = cur.op();
+            if (op == Token::MUL || op == Token::DIV || op == Token::RIGHT) {
+                throw std::runtime_error("A meets operator " + text(cur));
             }
             break;
         }
@@ -94,19 +218,22 @@ void Parser::A() {
 void Parser::tmpA() {
     switch (cur.type()) {
         case Token::NUMBER:
-            throw std::runtime_error("tmpA meets num " + cur.val());
+            throw std::runtime_error("tmpA meets num " + text(cur));
+            break;
+        case Token::VARIABLE:
+            throw std::runtime_error("tmpA meets variable " + text(cur));
             break;
         case Token::OPERATOR: {
-            auto val = cur.val();
-            if (val == "+" || val == "-") {
+            auto op = cur.op();
+            if (op == Token::ADD || op == Token::SUB) {
                 read();
                 A();
-                postfix.push_back(Token::oper(val));
+                postfix.push_back(Token::oper(op));
                 tmpA();
-            } else if (val == ")") {
+            } else if (op == Token::RIGHT) {
                 break;
             } else {
-                throw std::runtime_error("tmpA meets operator " + val);
+                throw std::runtime_error("tmpA meets operator " + text(cur));
             }
             break;
         }
@@ -118,25 +245,26 @@ void Parser::tmpA() {
 void Parser::B() {
     switch (cur.type()) {
         case Token::END_INPUT:
-            throw std::runtime_error("B meets " + cur.val());
+            throw std::runtime_error("B meets " + text(cur));
             break;
         case Token::NUMBER:
+        case Token::VARIABLE:
             factor();
             break;
         case Token::OPERATOR: {
-            auto val = cur.val();
-            if (val == "+") {
+            auto op = cur.op();
+            if (op == Token::ADD) {
                 read();
                 B();
-                postfix.push_back(Token::oper("@"));
-            } else if (val == "-") {
+                postfix.push_back(Token::oper(Token::POS));
+            } else if (op == Token::SUB) {
                 read();
                 B();
-                postfix.push_back(Token::oper("#"));
-            } else if (val == "(") {
+                postfix.push_back(Token::oper(Token::NEG));
+            } else if (op == Token::LEFT) {
                 factor();
             } else {
-                throw std::runtime_error("B meets operator " + val);
+                throw std::runtime_error("B meets operator " + text(cur));
             }
             break;
         }
@@ -148,17 +276,20 @@ void Parser::B() {
 void Parser::tmpB() {
     switch (cur.type()) {
         case Token::NUMBER:
-            throw std::runtime_error("tmpB meets num " + cur.val());
+            throw std::runtime_error("tmpB meets num " + text(cur));
+            break;
+        case Token::VARIABLE:
+            throw std::runtime_error("tmpB meets variable " + text(cur));
             break;
         case Token::OPERATOR: {
-            auto val = cur.val();
-            if (val == "*" || val == "/") {
+            auto op = cur.op();
+            if (op == Token::MUL || op == Token::DIV) {
                 read();
                 B();
-                postfix.push_back(Token::oper(val));
+                postfix.push_back(Token::oper(op));
                 tmpB();
-            } else if (val == "(") {
-                throw std::runtime_error("tmpB meets operator " + val);
+            } else if (op == Token::LEFT) {
+                throw std::runtime_error("tmpB meets operator " + text(cur));
             }
             break;
         }
@@ -170,22 +301,23 @@ void Parser::tmpB() {
 void Parser::factor() {
     switch (cur.type()) {
         case Token::END_INPUT:
-            throw std::runtime_error("factor meets " + cur.val());
+            throw std::runtime_error("factor meets " + text(cur));
             break;
         case Token::NUMBER:
+        case Token::VARIABLE:
             postfix.push_back(cur);
             read();
             break;
         case Token::OPERATOR:
-            if (cur.val() == "(") {
+            if (cur.op() == Token::LEFT) {
                 read();
                 expr();
-                if (cur != Token::oper(")")) {
+                if (cur != Token::oper(Token::RIGHT)) {
                     throw std::runtime_error("brackets mismatch");
                 }
                 read();
             } else {
-                throw std::runtime_error("factor meets operator " + cur.val());
+                throw std::runtime_error("factor meets operator " + text(cur));
             }
             break;
         default:
@@ -195,50 +327,107 @@ void Parser::factor() {
 
 // Calculator
 
-long Calculator::calculate() {
+std::int64_t Calculator::calculate() {
     const auto &toks = parser.parse();  // Postfix tokens
 
-    std::stack<std::string> s;
+    stack.clear();
     for (const auto &tok : toks) {
         if (tok.type() == Token::NUMBER) {
-            s.push(tok.val());
+            stack.push_back(tok.number());
+        } else if (tok.type() == Token::VARIABLE) {
+            throw std::runtime_error("unbound variable " + parser.getVariables()[tok.var()]);
         } else if (tok.type() == Token::OPERATOR) {
-            auto val = tok.val();
-            long lhs = 0, rhs = 0;
-            if (val == "@" || val == "#") {
-                if (s.size() < 1) {
-                    throw std::runtime_error("not enough operands for operator " + val);
+            auto op = tok.op();
+            if (op == Token::POS || op == Token::NEG) {
+                if (stack.size() < 1) {
+                    throw std::runtime_error("not enough operands for operator " + tok.str());
                 }
-                if (val == "#") {
-                    rhs = std::stol(s.top()); s.pop();
-                    s.push(std::to_string(-rhs));
+                if (op == Token::NEG) {
+                    stack.back() = checkedNeg(stack.back());
                 }
             } else {
-                if (s.size() < 2) {
-                    throw std::runtime_error("not enough operands for operator " + val);
+                if (stack.size() < 2) {
+                    throw std::runtime_error("not enough operands for operator " + tok.str());
                 }
-                rhs = std::stol(s.top()); s.pop();
-                lhs = std::stol(s.top()); s.pop();
-                if (val == "+") {
-                    s.push(std::to_string(lhs + rhs));
-                } else if (val == "-") {
-                    s.push(std::to_string(lhs - rhs));
-                } else if (val == "*") {
-                    s.push(std::to_string(lhs * rhs));
-                } else if (val == "/") {
-                    s.push(std::to_string(lhs / rhs));
-                } else {
-                    throw std::runtime_error("unknown operator " + val);
+                std::int64_t rhs = stack.back();
+                stack.pop_back();
+                std::int64_t &lhs = stack.back();
+                switch (op) {
+                    case Token::ADD:
+                        lhs = checkedAdd(lhs, rhs);
+                        break;
+                    case Token::SUB:
+                        lhs = checkedSub(lhs, rhs);
+                        break;
+                    case Token::MUL:
+                        lhs = checkedMul(lhs, rhs);
+                        break;
+                    case Token::DIV:
+                        lhs = checkedDiv(lhs, rhs);
+                        break;
+                    default:
+                        throw std::runtime_error("unknown operator " + tok.str());
                 }
             }
         }
     }
 
-    if (s.size() > 1) {
+    if (stack.size() > 1) {
         throw std::runtime_error("invalid postfix expression");
     }
 
-    return std::stol(s.top());
+    return stack.back();
+}
+
+// CompiledExpr
+
+CompiledExpr::SizeType CompiledExpr::getIndex(const std::string& var) const {
+    auto it = std::find(vars.begin(), vars.end(), var);
+    if (it == vars.end()) {
+        throw std::invalid_argument("no variable " + var);
+    }
+    return (SizeType)(it - vars.begin());
+}
+
+std::int64_t CompiledExpr::eval(const std::int64_t *const bindings) {
+    std::int64_t *top = stack.data();  // One past the top of the stack
+    for (const Instr &instr : code) {
+        switch (instr.op) {
+            case CONST:
+                *top++ = consts[instr.arg];
+                break;
+            case LOAD:
+                *top++ = bindings[instr.arg];
+                break;
+            case NEG:
+                top[-1] = checkedNeg(top[-1]);
+                break;
+            case ADD:
+                --top;
+                top[-1] = checkedAdd(top[-1], *top);
+                break;
+            case SUB:
+                --top;
+                top[-1] = checkedSub(top[-1], *top);
+                break;
+            case MUL:
+                --top;
+                top[-1] = checkedMul(top[-1], *top);
+                break;
+            case DIV:
+                --top;
+                top[-1] = checkedDiv(top[-1], *top);
+                break;
+        }
+    }
+    return top[-1];
+}
+
+std::int64_t CompiledExpr::eval(const std::vector<std::int64_t>& bindings) {
+    if (bindings.size() != vars.size()) {
+        throw std::invalid_argument("expect " + std::to_string(vars.size()) + " bindings");
+    }
+    return eval(bindings.data());
 }
 
 JUMBLE_NAMESPACE_END
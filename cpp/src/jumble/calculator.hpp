@@ -5,12 +5,19 @@
 #include <string>
 #include <iostream>
 #include <vector>
+#include <cstddef>
+#include <cstdint>
 
 JUMBLE_NAMESPACE_BEGIN
 
+/*
+A token of an arithmetic expression: a number, a variable, an operator
+or the end of input. Tokens hold their values directly, so copying them
+never allocates. A variable is the index of its name in the Lexer.
+*/
 class Token {
     friend bool operator==(const Token& lhs, const Token& rhs) noexcept {
-        return lhs.type_ == rhs.type_ && lhs.val_ == rhs.val_;
+        return lhs.type_ == rhs.type_ && lhs.num_ == rhs.num_ && lhs.op_ == rhs.op_;
     }
 
     friend bool operator!=(const Token& lhs, const Token& rhs) noexcept {
@@ -21,37 +28,78 @@ public:
     enum Type {
         END_INPUT,
         NUMBER,
+        VARIABLE,
         OPERATOR
     };
 
+    // Operators are their characters, any other character is an unknown operator
+    enum Op : char {
+        ADD = '+',
+        SUB = '-',
+        MUL = '*',
+        DIV = '/',
+        LEFT = '(',
+        RIGHT = ')',
+        POS = '@',  // Unary plus in postfix tokens
+        NEG = '#'   // Unary minus in postfix tokens
+    };
+
 public:
     static Token end() noexcept {
-        return Token(Type::END_INPUT, "$");
+        return Token(Type::END_INPUT, 0, Op('$'));
+    }
+
+    static Token num(const std::int64_t v) noexcept {
+        return Token(Type::NUMBER, v, Op(0));
     }
 
-    static Token num(const std::string& v) noexcept {
-        return Token(Type::NUMBER, v);
+    static Token var(const std::size_t index) noexcept {
+        return Token(Type::VARIABLE, (std::int64_t)index, Op(0));
     }
 
-    static Token oper(const std::string& v) noexcept {
-        return Token(Type::OPERATOR, v);
+    static Token oper(const Op v) noexcept {
+        return Token(Type::OPERATOR, 0, v);
     }
 
     Type type() const noexcept {
         return type_;
     }
 
-    const std::string& val() const noexcept {
-        return val_;
+    // Return the value of a number token
+    std::int64_t number() const noexcept {
+        return num_;
+    }
+
+    // Return the index of the name of a variable token
+    std::size_t var() const noexcept {
+        return (std::size_t)num_;
+    }
+
+    // Return the operator of an operator token
+    Op op() const noexcept {
+        return op_;
+    }
+
+    // Return the text of the token for messages, a variable is shown by its index
+    std::string str() const {
+        switch (type_) {
+            case Type::NUMBER:
+                return std::to_string(num_);
+            case Type::VARIABLE:
+                return "var" + std::to_string(num_);
+            default:
+                return std::string(1, op_);
+        }
     }
 
 private:
-    Token(const Type t, const std::string& v) noexcept
-        : type_(t), val_(v) {}
+    Token(const Type t, const std::int64_t n, const Op o) noexcept
+        : type_(t), num_(n), op_(o) {}
 
 private:
     Type type_;
-    std::string val_;
+    std::int64_t num_;
+    Op op_;
 };
 
 
@@ -59,12 +107,97 @@ class Lexer {
 public:
     Lexer(std::istream& i) noexcept : cur(' '), is(i) {}
 
-    // Read and parser one token from input stream
+    /*
+    Read and parse one token from input stream. A variable is a letter
+    or '_' followed by letters, digits or '_'.
+
+    @throw std::runtime_error if a number does not fit in 64 bits
+    */
     Token scan();
 
+    // Forget the character read ahead and the variables, e.g. after the stream is refilled
+    void reset() noexcept {
+        cur = ' ';
+        names.clear();
+    }
+
+    // Return the names of the variables scanned, in the order of their first appearance
+    const std::vector<std::string>& getNames() const noexcept {
+        return names;
+    }
+
 private:
     char cur;
     std::istream &is;
+    std::string name;                // The variable being scanned
+    std::vector<std::string> names;  // Indexed by Token::var()
+};
+
+
+/*
+An expression compiled to postfix bytecode by Parser::compile(). It is
+evaluated for any values of its variables without lexing or parsing,
+on a stack sized at compile time.
+*/
+class CompiledExpr {
+public:
+    using SizeType = std::size_t;
+
+    // Return the names of the variables, in the order of the bindings of eval()
+    const std::vector<std::string>& getVariables() const noexcept {
+        return vars;
+    }
+
+    /*
+    Return the index of a variable in the bindings of eval().
+
+    @throw std::invalid_argument if the expression has no such variable
+    */
+    SizeType getIndex(const std::string& var) const;
+
+    /*
+    Evaluate the expression. It uses the stack of the object, so one
+    object must not be evaluated by several threads at the same time.
+
+    @param bindings The values of the variables, see getVariables()
+    @return         The result
+    @throw std::runtime_error on division by zero or overflow
+    */
+    std::int64_t eval(const std::int64_t *bindings);
+
+    /*
+    Evaluate the expression.
+
+    @param bindings The values of the variables, see getVariables()
+    @return         The result
+    @throw std::invalid_argument if the amount of bindings is not the amount of variables
+    @throw std::runtime_error on division by zero or overflow
+    */
+    std::int64_t eval(const std::vector<std::int64_t>& bindings);
+
+private:
+    friend class Parser;
+
+    enum Opcode : std::uint8_t {
+        CONST,  // Push consts[arg]
+        LOAD,   // Push bindings[arg]
+        NEG,
+        ADD,
+        SUB,
+        MUL,
+        DIV
+    };
+
+    struct Instr {
+        Opcode op;
+        std::uint32_t arg;
+    };
+
+private:
+    std::vector<Instr> code;
+    std::vector<std::int64_t> consts;
+    std::vector<std::string> vars;
+    std::vector<std::int64_t> stack;  // As deep as the expression needs
 };
 
 
@@ -74,15 +207,31 @@ public:
 
     /*
     Parse an infix arithmetic expression and return its postfix tokens.
+    The parser can be called again after the stream is refilled.
 
     @throw std::runtime_error if parse failed
     */
     const std::vector<Token>& parse();
 
+    /*
+    Parse an infix arithmetic expression and compile it for evaluation.
+
+    @throw std::runtime_error if parse failed
+    */
+    CompiledExpr compile();
+
+    // Return the names of the variables of the last expression, see Token::var()
+    const std::vector<std::string>& getVariables() const noexcept {
+        return lexer.getNames();
+    }
+
 private:
     void read() {
         cur = lexer.scan();
     }
+
+    // Return the text of a token for messages
+    std::string text(const Token& tok) const;
     
     // Recursive descent of nonterminals
     void expr();
@@ -104,14 +253,18 @@ public:
     Calculator(std::istream& i) noexcept : parser(i) {}
 
     /*
-    Return the result of an infix arithmetic expression.
+    Return the result of an infix arithmetic expression. Once the
+    buffers are grown, calling it again after the stream is refilled
+    allocates nothing.
 
-    @throw std::runtime_error if the expression is invalid
+    @throw std::runtime_error if the expression is invalid, has
+           variables, divides by zero or overflows
     */
-    long calculate();
+    std::int64_t calculate();
 
 private:
     Parser parser;
+    std::vector<std::int64_t> stack;
 };
 
 JUMBLE_NAMESPACE_END
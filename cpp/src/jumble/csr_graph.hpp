@@ -0,0 +1,181 @@
+#ifndef JUMBLE_CSR_GRAPH_HPP_INCLUDED
+#define JUMBLE_CSR_GRAPH_HPP_INCLUDED
+
+#include "jumble/graph.hpp"
+#include <vector>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+#include <cstddef>
+#include <cstdint>
+
+JUMBLE_NAMESPACE_BEGIN
+
+/*
+An immutable graph stored in compressed sparse row (CSR) format.
+The outgoing edges of vertex 'v' are stored contiguously at
+[offsets[v], offsets[v + 1]) of the target and weight arrays,
+which makes it suitable for scanning huge graphs in parallel.
+
+The arrays are either owned by the graph or borrowed from external
+memory (e.g. a mapped file) kept alive by a shared owner, so copying
+a graph is cheap and never copies the arrays.
+
+@param Num    The type of vertex numbers, see Graph. It also
+              stores edge offsets, so it must hold the amount of edges.
+@param Weight The type of edge weights, see Graph
+*/
+template<typename Num = std::size_t, typename Weight = std::int32_t>
+class BasicCSRGraph {
+public:
+    using NumType = Num;
+    using WeightType = Weight;
+
+    // Build an empty graph
+    BasicCSRGraph() : BasicCSRGraph(std::vector<NumType>(1, 0), {}, {}) {}
+
+    /*
+    Build the graph from raw CSR arrays.
+
+    @param offsets_ The edge offsets of each vertex, size must be (#vertices + 1)
+    @param targets_ The ending vertex number of each edge
+    @param weights_ The weight of each edge
+    @throw std::invalid_argument if the arrays are inconsistent
+    */
+    BasicCSRGraph(std::vector<NumType> offsets_,
+                  std::vector<NumType> targets_,
+                  std::vector<WeightType> weights_) {
+        if (offsets_.empty() || offsets_.front() != 0 || offsets_.back() != targets_.size()
+            || targets_.size() != weights_.size()) {
+            throw std::invalid_argument("inconsistent CSR arrays");
+        }
+        auto arrays = std::make_shared<Arrays>();
+        arrays->offsets = std::move(offsets_);
+        arrays->targets = std::move(targets_);
+        arrays->weights = std::move(weights_);
+        size = arrays->offsets.size() - 1;
+        offsets = arrays->offsets.data();
+        targets = arrays->targets.data();
+        weights = arrays->weights.data();
+        owner = std::move(arrays);
+    }
+
+    /*
+    Build the graph upon arrays in external memory without copying them.
+    Precondition: the arrays are consistent (see the ctor above).
+
+    @param n        The amount of vertices
+    @param offsets_ The edge offsets of each vertex, (n + 1) elements
+    @param targets_ The ending vertex number of each edge
+    @param weights_ The weight of each edge
+    @param owner_   The object keeping the arrays alive
+    */
+    BasicCSRGraph(const NumType n,
+                  const NumType *const offsets_,
+                  const NumType *const targets_,
+                  const WeightType *const weights_,
+                  std::shared_ptr<const void> owner_) noexcept
+        : size(n), offsets(offsets_), targets(targets_), weights(weights_),
+          owner(std::move(owner_)) {}
+
+    /*
+    Build the graph from the edges of a Graph object.
+
+    @param graph The graph object in either storage type
+    */
+    template<typename Value>
+    explicit BasicCSRGraph(const Graph<Value, NumType, WeightType>& graph)
+        : BasicCSRGraph(fromGraph(graph)) {}
+
+    // Return the amount of vertices in the graph
+    NumType getSize() const noexcept {
+        return size;
+    }
+
+    // Return the amount of edges in the graph
+    NumType getEdgeCount() const noexcept {
+        return offsets[size];
+    }
+
+    // Return the amount of outgoing edges of a given vertex
+    NumType getDegree(const NumType v) const noexcept {
+        return offsets[v + 1] - offsets[v];
+    }
+
+    // Return the first neighbor of a given vertex
+    const NumType* neighborBegin(const NumType v) const noexcept {
+        return targets + offsets[v];
+    }
+
+    // Return the position after the last neighbor of a given vertex
+    const NumType* neighborEnd(const NumType v) const noexcept {
+        return targets + offsets[v + 1];
+    }
+
+    // Return the weight of the edge to the first neighbor of a given vertex
+    const WeightType* weightBegin(const NumType v) const noexcept {
+        return weights + offsets[v];
+    }
+
+    /*
+    Return the graph with every edge reversed. The neighbors
+    of each vertex in the result are in ascending order.
+    */
+    BasicCSRGraph transpose() const {
+        NumType n = getSize();
+        std::vector<NumType> tOffsets(n + 1, 0);
+        for (NumType i = 0; i < getEdgeCount(); ++i) {
+            ++tOffsets[targets[i] + 1];
+        }
+        for (NumType v = 0; v < n; ++v) {
+            tOffsets[v + 1] += tOffsets[v];
+        }
+        std::vector<NumType> pos(tOffsets.begin(), tOffsets.end() - 1);
+        std::vector<NumType> tTargets(getEdgeCount());
+        std::vector<WeightType> tWeights(getEdgeCount());
+        for (NumType v = 0; v < n; ++v) {
+            for (NumType i = offsets[v]; i < offsets[v + 1]; ++i) {
+                NumType p = pos[targets[i]]++;
+                tTargets[p] = v;
+                tWeights[p] = weights[i];
+            }
+        }
+        return BasicCSRGraph(std::move(tOffsets), std::move(tTargets), std::move(tWeights));
+    }
+
+private:
+    // Arrays owned by the graph
+    struct Arrays {
+        std::vector<NumType> offsets;
+        std::vector<NumType> targets;
+        std::vector<WeightType> weights;
+    };
+
+    template<typename Value>
+    static BasicCSRGraph fromGraph(const Graph<Value, NumType, WeightType>& graph) {
+        std::vector<NumType> offsets(graph.getSize() + 1, 0);
+        std::vector<NumType> targets;
+        std::vector<WeightType> weights;
+        for (NumType v = 0; v < graph.getSize(); ++v) {
+            graph.traverse(v, [&](const NumType to, const WeightType w) {
+                targets.push_back(to);
+                weights.push_back(w);
+            });
+            offsets[v + 1] = targets.size();
+        }
+        return BasicCSRGraph(std::move(offsets), std::move(targets), std::move(weights));
+    }
+
+private:
+    NumType size;
+    const NumType *offsets;
+    const NumType *targets;
+    const WeightType *weights;
+    std::shared_ptr<const void> owner;
+};
+
+using CSRGraph = BasicCSRGraph<>;
+
+JUMBLE_NAMESPACE_END
+
+#endif
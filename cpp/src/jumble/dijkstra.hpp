@@ -8,21 +8,23 @@ JUMBLE_NAMESPACE_BEGIN
 /*
 The value stored in each vertex when running Dijkstra's algorithm.
 
-@praram Value The type of other values stored in each vertex
+@praram Value  The type of other values stored in each vertex
+@param  Num    The type of vertex numbers
+@param  Weight The type of edge weights
 */
-template<typename Value>
+template<typename Value, typename Num = std::size_t, typename Weight = std::int32_t>
 struct DijkValue {
     bool visit;
-    typename Graph<DijkValue<Value>>::WeightType dist;
-    typename Graph<DijkValue<Value>>::NumType prev;
+    Weight dist;
+    Num prev;
     Value val;
 };
 
 /*
 Graph object used for Dijkstra's algorithm.
 */
-template<typename Value>
-using DijkGraph = Graph<DijkValue<Value>>;
+template<typename Value, typename Num = std::size_t, typename Weight = std::int32_t>
+using DijkGraph = Graph<DijkValue<Value, Num, Weight>, Num, Weight>;
 
 /*
 The Dijkstra's algorithm to find the shortest
@@ -33,15 +35,19 @@ After its execution, for each vertex 'i' in the graph:
 2. graph[i].prev denotes the previous vertex of vertex 'i' on the minimum path.
 If 'i' is the starting vertex, then graph[i].prev == graph.getSize() + 1.
 
+The weights must be non-negative. Distances are summed in the weight type
+and saturate at MAX_WEIGHT, so a vertex whose distance would exceed the
+range of the weight type is unreachable, with dist == MAX_WEIGHT.
+
 @param graph The graph object
 @param src   The starting vertex number
 */
-template<typename Value>
-void dijkstra(DijkGraph<Value>& graph,
-              const typename DijkGraph<Value>::NumType src) {
-    using G          = DijkGraph<Value>;
-    using NumType    = typename DijkGraph<Value>::NumType;
-    using WeightType = typename DijkGraph<Value>::WeightType;
+template<typename Value, typename Num, typename Weight>
+void dijkstra(DijkGraph<Value, Num, Weight>& graph,
+              const typename DijkGraph<Value, Num, Weight>::NumType src) {
+    using G          = DijkGraph<Value, Num, Weight>;
+    using NumType    = typename G::NumType;
+    using WeightType = typename G::WeightType;
 
     // Init
     NumType size = graph.getSize();
@@ -64,14 +70,15 @@ void dijkstra(DijkGraph<Value>& graph,
             break;  // All vertices are visited
         }
         graph[cur].visit = true;
-        std::vector<NumType> neighbors = graph.getNeighbors(cur);
-        for (const auto &adj : neighbors) {
-            WeightType w = graph.getWeight(cur, adj);
-            if (!graph[adj].visit && graph[cur].dist + w < graph[adj].dist) {
-                graph[adj].dist = graph[cur].dist + w;
+        graph.traverse(cur, [&](const NumType adj, const WeightType w) {
+            // Saturate instead of wrapping around in narrow weight types
+            WeightType dist = w < G::MAX_WEIGHT - graph[cur].dist
+                ? (WeightType)(graph[cur].dist + w) : G::MAX_WEIGHT;
+            if (!graph[adj].visit && dist < graph[adj].dist) {
+                graph[adj].dist = dist;
                 graph[adj].prev = cur;
             }
-        }
+        });
     }
 }
 
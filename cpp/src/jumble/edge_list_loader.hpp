@@ -0,0 +1,425 @@
+#ifndef JUMBLE_EDGE_LIST_LOADER_HPP_INCLUDED
+#define JUMBLE_EDGE_LIST_LOADER_HPP_INCLUDED
+
+#include "jumble/csr_graph.hpp"
+#include "jumble/util/mapped_file.hpp"
+#include "jumble/util/thread_pool.hpp"
+#include <string>
+#include <vector>
+#include <atomic>
+#include <memory>
+#include <chrono>
+#include <algorithm>
+#include <stdexcept>
+#include <limits>
+#include <type_traits>
+#include <cstddef>
+#include <cstdint>
+
+JUMBLE_NAMESPACE_BEGIN
+
+/*
+A loader of graphs from text edge lists. Each line of the input is
+either an edge "from to [weight]" (the weight is 1 if omitted),
+a comment starting with '#' or '%', or a blank line.
+
+The input is split into chunks at line boundaries which are parsed
+in parallel. The edges are then grouped by their starting vertices
+with a counting sort, so the graph is built without looking up any
+existing edge. If an edge appears more than once, the last one wins,
+like calling Graph::setWeight() for each line in order.
+
+Weights are parsed as integers, or as decimals like "-1.5e3" if the
+weight type is floating-point.
+
+@param Num    The type of vertex numbers, see Graph
+@param Weight The type of edge weights, see Graph
+*/
+template<typename Num = std::size_t, typename Weight = std::int32_t>
+class BasicEdgeListLoader {
+public:
+    using SizeType = std::size_t;
+    using NumType = Num;
+    using WeightType = Weight;
+    using GraphType = BasicCSRGraph<NumType, WeightType>;
+
+    // Statistics of the last load
+    struct Stats {
+        SizeType bytes = 0;       // Amount of bytes parsed
+        std::uint64_t edges = 0;  // Amount of edge lines parsed
+        double seconds = 0;       // Time to parse and build the graph
+
+        double edgesPerSecond() const noexcept {
+            return seconds > 0 ? edges / seconds : 0;
+        }
+    };
+
+    /*
+    Initialize the loader.
+
+    @param pool_ The threads to parse and build graphs
+    */
+    explicit BasicEdgeListLoader(ThreadPool& pool_) noexcept : pool(pool_) {}
+
+    /*
+    Load a graph from an edge list file.
+
+    @param path The path of the file
+    @param n    The minimum amount of vertices. The graph has
+                (max vertex number + 1) vertices if it is greater.
+    @throw std::runtime_error if the file cannot be read or parsed
+    */
+    GraphType load(const std::string& path, const NumType n = 0) {
+        MappedFile file(path);
+        return parse(reinterpret_cast<const char*>(file.data()), file.getSize(), n);
+    }
+
+    /*
+    Load a Graph object from an edge list file.
+
+    @param path The path of the file
+    @param type The storage type of the graph
+    @param n    The minimum amount of vertices
+    @throw std::runtime_error if the file cannot be read or parsed
+    */
+    template<typename Value>
+    Graph<Value, NumType, WeightType> loadGraph(
+            const std::string& path,
+            const typename Graph<Value, NumType, WeightType>::StorageType type
+                = Graph<Value, NumType, WeightType>::LIST,
+            const NumType n = 0) {
+        auto start = Clock::now();
+        GraphType csr = load(path, n);
+        Graph<Value, NumType, WeightType> graph(csr.getSize(), type);
+        pool.parallelFor(0, csr.getSize(), [&](const NumType beg, const NumType end) {
+            for (NumType v = beg; v < end; ++v) {
+                for (NumType i = 0; i < csr.getDegree(v); ++i) {
+                    graph.addEdge(v, csr.neighborBegin(v)[i], csr.weightBegin(v)[i]);
+                }
+            }
+        });
+        stats.seconds = elapsed(start);
+        return graph;
+    }
+
+    /*
+    Parse an edge list in memory.
+
+    @param data The first character of the edge list
+    @param len  The amount of characters
+    @param n    The minimum amount of vertices
+    @throw std::runtime_error if the edge list cannot be parsed
+    */
+    GraphType parse(const char *const data, const SizeType len, const NumType n = 0) {
+        auto start = Clock::now();
+
+        // Split the input at line boundaries
+        SizeType chunkNum = std::max((SizeType)1, std::min(pool.getSize() * CHUNKS_PER_THREAD,
+                                                           len / MIN_CHUNK_BYTES));
+        std::vector<SizeType> bounds(chunkNum + 1, len);
+        bounds[0] = 0;
+        for (SizeType c = 1; c < chunkNum; ++c) {
+            SizeType pos = std::max(len / chunkNum * c, bounds[c - 1]);
+            while (pos < len && data[pos - 1] != '\n') {
+                ++pos;
+            }
+            bounds[c] = pos;
+        }
+
+        // Parse each chunk
+        std::vector<std::vector<RawEdge>> chunks(chunkNum);
+        std::vector<NumType> sizes(chunkNum, n);
+        pool.parallelFor(0, chunkNum, [&](const SizeType beg, const SizeType end) {
+            for (SizeType c = beg; c < end; ++c) {
+                parseChunk(data, bounds[c], bounds[c + 1], chunks[c], sizes[c]);
+            }
+        });
+        std::vector<std::uint64_t> seqBase(chunkNum + 1, 0);
+        for (SizeType c = 0; c < chunkNum; ++c) {
+            seqBase[c + 1] = seqBase[c] + chunks[c].size();
+        }
+        const NumType size = *std::max_element(sizes.begin(), sizes.end());
+        const NumType total = (NumType)seqBase[chunkNum];
+
+        // Count the edges of each vertex
+        std::unique_ptr<std::atomic<NumType>[]> cursor(new std::atomic<NumType>[size]);
+        pool.parallelFor(0, size, [&](const NumType beg, const NumType end) {
+            for (NumType v = beg; v < end; ++v) {
+                cursor[v].store(0, std::memory_order_relaxed);
+            }
+        });
+        pool.parallelFor(0, chunkNum, [&](const SizeType beg, const SizeType end) {
+            for (SizeType c = beg; c < end; ++c) {
+                for (const auto &e : chunks[c]) {
+                    cursor[e.from].fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+        });
+        std::vector<NumType> offsets(size + 1, 0);
+        for (NumType v = 0; v < size; ++v) {
+            offsets[v + 1] = offsets[v] + cursor[v].load(std::memory_order_relaxed);
+            cursor[v].store(offsets[v], std::memory_order_relaxed);
+        }
+
+        // Scatter the edges to their starting vertices
+        std::vector<SortEdge> sorted(total);
+        pool.parallelFor(0, chunkNum, [&](const SizeType beg, const SizeType end) {
+            for (SizeType c = beg; c < end; ++c) {
+                std::uint64_t seq = seqBase[c];
+                for (const auto &e : chunks[c]) {
+                    NumType pos = cursor[e.from].fetch_add(1, std::memory_order_relaxed);
+                    sorted[pos] = SortEdge{e.to, e.weight, seq++};
+                }
+                std::vector<RawEdge>().swap(chunks[c]);
+            }
+        });
+
+        // Order the edges of each vertex and keep the last one of duplicates
+        std::vector<NumType> degree(size);
+        pool.parallelFor(0, size, [&](const NumType beg, const NumType end) {
+            for (NumType v = beg; v < end; ++v) {
+                degree[v] = dedupe(sorted.data() + offsets[v], sorted.data() + offsets[v + 1]);
+            }
+        });
+        std::vector<NumType> finalOffsets(size + 1, 0);
+        for (NumType v = 0; v < size; ++v) {
+            finalOffsets[v + 1] = finalOffsets[v] + degree[v];
+        }
+        std::vector<NumType> targets(finalOffsets[size]);
+        std::vector<WeightType> weights(finalOffsets[size]);
+        pool.parallelFor(0, size, [&](const NumType beg, const NumType end) {
+            for (NumType v = beg; v < end; ++v) {
+                for (NumType i = 0; i < degree[v]; ++i) {
+                    targets[finalOffsets[v] + i] = sorted[offsets[v] + i].to;
+                    weights[finalOffsets[v] + i] = sorted[offsets[v] + i].weight;
+                }
+            }
+        });
+
+        stats.bytes = len;
+        stats.edges = seqBase[chunkNum];
+        stats.seconds = elapsed(start);
+        return GraphType(std::move(finalOffsets), std::move(targets), std::move(weights));
+    }
+
+    // Return the statistics of the last load
+    const Stats& getStats() const noexcept {
+        return stats;
+    }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct RawEdge {
+        NumType from;
+        NumType to;
+        WeightType weight;
+    };
+
+    struct SortEdge {
+        NumType to;
+        WeightType weight;
+        std::uint64_t seq;  // Position in the input
+    };
+
+    static double elapsed(const Clock::time_point start) {
+        return std::chrono::duration<double>(Clock::now() - start).count();
+    }
+
+    static bool isBlank(const char c) noexcept {
+        return c == ' ' || c == '\t' || c == '\r';
+    }
+
+    static bool isDigit(const char c) noexcept {
+        return c >= '0' && c <= '9';
+    }
+
+    static std::runtime_error parseError(const SizeType pos) {
+        return std::runtime_error("invalid edge list at byte " + std::to_string(pos));
+    }
+
+    /*
+    Parse a non-negative integer no greater than 'max'.
+
+    @param data The input
+    @param pos  The position to start, updated to the position after the number
+    @param end  The position after the last character of the input
+    */
+    static std::uint64_t parseUInt(const char *const data, SizeType& pos, const SizeType end,
+                                   const std::uint64_t max) {
+        if (pos == end || !isDigit(data[pos])) {
+            throw parseError(pos);
+        }
+        std::uint64_t val = 0;
+        for (; pos < end && isDigit(data[pos]); ++pos) {
+            std::uint64_t d = (std::uint64_t)(data[pos] - '0');
+            if (val > (max - d) / 10) {
+                throw parseError(pos);
+            }
+            val = 10 * val + d;
+        }
+        return val;
+    }
+
+    // Parse an optionally signed integer weight
+    static WeightType parseWeight(const char *const data, SizeType& pos, const SizeType end,
+                                  std::false_type) {
+        bool neg = data[pos] == '-';
+        if (neg || data[pos] == '+') {
+            ++pos;
+        }
+        if (neg && !std::numeric_limits<WeightType>::is_signed) {
+            throw parseError(pos);
+        }
+        std::uint64_t max = (std::uint64_t)std::numeric_limits<WeightType>::max() + (neg ? 1 : 0);
+        std::uint64_t w = parseUInt(data, pos, end, max);
+        return neg ? (WeightType)(-(std::int64_t)w) : (WeightType)w;
+    }
+
+    /*
+    Parse a floating-point weight in decimal notation. The result is
+    exact (correctly rounded) if the significand has at most 15 digits
+    and the decimal exponent is within [-22, 22].
+    */
+    static WeightType parseWeight(const char *const data, SizeType& pos, const SizeType end,
+                                  std::true_type) {
+        static const double POW10[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10,
+                                       1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19,
+                                       1e20, 1e21, 1e22};
+        bool neg = data[pos] == '-';
+        if (neg || data[pos] == '+') {
+            ++pos;
+        }
+        std::uint64_t mant = 0;
+        int exp = 0, digits = 0;
+        for (; pos < end && isDigit(data[pos]); ++pos, ++digits) {
+            if (mant < MAX_MANTISSA) {
+                mant = 10 * mant + (std::uint64_t)(data[pos] - '0');
+            } else {
+                ++exp;  // Drop digits beyond the precision
+            }
+        }
+        if (pos < end && data[pos] == '.') {
+            for (++pos; pos < end && isDigit(data[pos]); ++pos, ++digits) {
+                if (mant < MAX_MANTISSA) {
+                    mant = 10 * mant + (std::uint64_t)(data[pos] - '0');
+                    --exp;
+                }
+            }
+        }
+        if (digits == 0) {
+            throw parseError(pos);
+        }
+        if (pos < end && (data[pos] == 'e' || data[pos] == 'E')) {
+            ++pos;
+            bool expNeg = pos < end && data[pos] == '-';
+            if (pos < end && (expNeg || data[pos] == '+')) {
+                ++pos;
+            }
+            int e = (int)parseUInt(data, pos, end, 9999);
+            exp += expNeg ? -e : e;
+        }
+        double val = (double)mant;
+        for (; exp > 22; exp -= 22) {
+            val *= POW10[22];
+        }
+        for (; exp < -22; exp += 22) {
+            val /= POW10[22];
+        }
+        val = exp < 0 ? val / POW10[-exp] : val * POW10[exp];
+        return (WeightType)(neg ? -val : val);
+    }
+
+    /*
+    Parse the edges in [beg, end) of the input.
+
+    @param data  The input
+    @param beg   The position of the first character
+    @param end   The position after the last character
+    @param edges Store the parsed edges
+    @param size  Updated to be greater than any vertex number
+    */
+    static void parseChunk(const char *const data, const SizeType beg, const SizeType end,
+                           std::vector<RawEdge>& edges, NumType& size) {
+        const std::uint64_t maxNum = std::numeric_limits<NumType>::max() - 1;
+        SizeType pos = beg;
+        while (pos < end) {
+            while (pos < end && isBlank(data[pos])) {
+                ++pos;
+            }
+            if (pos == end) {
+                break;
+            }
+            if (data[pos] == '\n') {
+                ++pos;
+                continue;
+            }
+            if (data[pos] == '#' || data[pos] == '%') {
+                while (pos < end && data[pos++] != '\n') {}
+                continue;
+            }
+
+            RawEdge e;
+            e.from = (NumType)parseUInt(data, pos, end, maxNum);
+            if (pos == end || !isBlank(data[pos])) {
+                throw parseError(pos);
+            }
+            while (pos < end && isBlank(data[pos])) {
+                ++pos;
+            }
+            e.to = (NumType)parseUInt(data, pos, end, maxNum);
+            if (pos < end && data[pos] != '\n' && !isBlank(data[pos])) {
+                throw parseError(pos);
+            }
+            while (pos < end && isBlank(data[pos])) {
+                ++pos;
+            }
+            e.weight = 1;
+            if (pos < end && data[pos] != '\n') {
+                e.weight = parseWeight(data, pos, end, std::is_floating_point<WeightType>());
+                while (pos < end && isBlank(data[pos])) {
+                    ++pos;
+                }
+                if (pos < end && data[pos] != '\n') {
+                    throw parseError(pos);
+                }
+            }
+            edges.push_back(e);
+            size = std::max(size, std::max(e.from, e.to) + 1);
+        }
+    }
+
+    /*
+    Sort the edges of one vertex by their ending vertices, keep the
+    last one of duplicates and remove those with an infinite weight.
+
+    @return The amount of remaining edges, moved to the front
+    */
+    static NumType dedupe(SortEdge *const beg, SortEdge *const end) {
+        std::sort(beg, end, [](const SortEdge& a, const SortEdge& b) {
+            return a.to < b.to || (a.to == b.to && a.seq < b.seq);
+        });
+        SortEdge *out = beg;
+        for (SortEdge *it = beg; it != end; ++it) {
+            if ((it + 1 == end || (it + 1)->to != it->to)
+                && !Graph<int, NumType, WeightType>::isINF(it->weight)) {
+                *out++ = *it;
+            }
+        }
+        return (NumType)(out - beg);
+    }
+
+private:
+    static const SizeType CHUNKS_PER_THREAD = 4;
+    static const SizeType MIN_CHUNK_BYTES = 1 << 16;
+    static const std::uint64_t MAX_MANTISSA = 100000000000000ULL;  // Keep up to 15 digits
+
+    ThreadPool &pool;
+    Stats stats;
+};
+
+using EdgeListLoader = BasicEdgeListLoader<>;
+
+JUMBLE_NAMESPACE_END
+
+#endif
@@ -1,9 +1,12 @@
 #ifndef JUMBLE_GRAPH_HPP_INCLUDED
 #define JUMBLE_GRAPH_HPP_INCLUDED
 
-#include "jumble/util/common.hpp"
+#include "jumble/util/bit_ops.hpp"
 #include <vector>
 #include <list>
+#include <algorithm>
+#include <iterator>
+#include <limits>
 #include <cstddef>
 #include <cstdint>
 
@@ -12,23 +15,48 @@ JUMBLE_NAMESPACE_BEGIN
 /*
 A data structure to implement the directed/undirected graph
 concepts from mathematics. It stores a graph in an adjacency
-list or matrix.
+list, matrix or bitset.
 
-@param Value The type of the values stored in each vertex
+@param Value  The type of the values stored in each vertex
+@param Num    The unsigned integer type of vertex numbers, e.g. std::uint32_t
+              for graphs with less than 2^32 - 1 vertices to halve the memory
+              of adjacency lists
+@param Weight The arithmetic type of edge weights. An edge weighted
+              MAX_WEIGHT or MIN_WEIGHT is considered not exist. They are
+              the infinities of floating-point types, the maximum and minimum
+              values of signed integer types and both the maximum value of
+              unsigned integer types.
 */
-template<typename Value = int>
+template<typename Value = int, typename Num = std::size_t, typename Weight = std::int32_t>
 class Graph {
 public:
-    using NumType = std::size_t;
-    using WeightType = std::int32_t;
+    using NumType = Num;
+    using WeightType = Weight;
 
-    static const WeightType MAX_WEIGHT = INT32_MAX;
-    static const WeightType MIN_WEIGHT = INT32_MIN;
+    static_assert(std::numeric_limits<NumType>::is_integer && !std::numeric_limits<NumType>::is_signed,
+                  "vertex number type must be an unsigned integer");
+    static_assert(std::numeric_limits<WeightType>::is_specialized,
+                  "weight type must be arithmetic");
 
-    // Type of storage: adjacency list or matrix
+    static constexpr WeightType MAX_WEIGHT = std::numeric_limits<WeightType>::has_infinity
+        ? std::numeric_limits<WeightType>::infinity()
+        : std::numeric_limits<WeightType>::max();
+    static constexpr WeightType MIN_WEIGHT = !std::numeric_limits<WeightType>::is_signed
+        ? MAX_WEIGHT
+        : std::numeric_limits<WeightType>::has_infinity
+        ? -std::numeric_limits<WeightType>::infinity()
+        : std::numeric_limits<WeightType>::lowest();
+
+    /*
+    Type of storage: adjacency list, matrix or bitset.
+    The bitset keeps one bit per vertex pair instead of one WeightType, so it
+    stores unweighted graphs in a fraction of the matrix memory. Every edge
+    in it has weight 1 and self loops are ignored.
+    */
     enum StorageType {
         LIST,
-        MATRIX
+        MATRIX,
+        BITSET
     };
 
     /*
@@ -45,6 +73,10 @@ public:
                     vertices[i].weight.push_back(i == j ? 0 : MAX_WEIGHT);
                 }
             }
+        } else if (type == BITSET) {
+            for (NumType i = 0; i < n_; ++i) {
+                vertices[i].bits.resize(getWordCount());
+            }
         }
     }
 
@@ -63,6 +95,10 @@ public:
         return vertices[v].val;
     }
 
+    const Value& operator[](const NumType v) const {
+        return vertices[v].val;
+    }
+
     /*
     Return the weight of an edge.
 
@@ -78,6 +114,11 @@ public:
                     }
                 }
                 return MAX_WEIGHT;
+            case BITSET:
+                if (from == to) {
+                    return 0;
+                }
+                return hasBit(from, to) ? 1 : MAX_WEIGHT;
             case MATRIX:
             default:
                 return vertices[from].weight[to];
@@ -109,6 +150,13 @@ public:
                 }
                 break;
             }
+            case BITSET:
+                if (isINF(w)) {
+                    clearBit(from, to);
+                } else {
+                    setBit(from, to);
+                }
+                break;
             case MATRIX:
             default:
                 vertices[from].weight[to] = w;
@@ -117,31 +165,115 @@ public:
     }
 
     /*
-    Return all neighbors of a given vertex.
+    Add an edge without looking for an existing one, which takes
+    constant time in both storage types. Edges of different
+    starting vertices can be added concurrently.
+    Precondition: the edge does not exist in the graph.
+
+    @param from The starting vertex number of the edge
+    @param to   The ending vertex number of the edge
+    @param w    The weight of the edge
+    */
+    void addEdge(const NumType from, const NumType to, const WeightType w) {
+        switch (type) {
+            case LIST:
+                vertices[from].neighbors.push_back(AdjVertex(to, w));
+                break;
+            case BITSET:
+                if (!isINF(w)) {
+                    setBit(from, to);
+                }
+                break;
+            case MATRIX:
+            default:
+                vertices[from].weight[to] = w;
+                break;
+        }
+    }
+
+    /*
+    Visit all outgoing edges of a given vertex.
     An edge that has the maximum or minimum weight is considered not exist.
+
+    @param v The vertex number
+    @param f The function to visit each edge. Params are:
+             @param to The ending vertex number of the edge
+             @param w  The weight of the edge
     */
-    std::vector<NumType> getNeighbors(const NumType v) const {
-        std::vector<NumType> res;
+    template<typename Func>
+    void traverse(const NumType v, Func f) const {
         switch (type) {
             case LIST:
                 for (const auto &n : vertices[v].neighbors) {
                     if (!isINF(n.weight)) {
-                        res.push_back(n.num);
+                        f(n.num, n.weight);
                     }
                 }
                 break;
+            case BITSET:
+                forEachSetBit(vertices[v].bits.data(), getWordCount(), [&](const std::size_t i) {
+                    f((NumType)i, (WeightType)1);
+                });
+                break;
             case MATRIX:
             default:
                 for (NumType i = 0; i < vertices.size(); ++i) {
                     if (v != i && !isINF(vertices[v].weight[i])) {
-                        res.push_back(i);
+                        f(i, vertices[v].weight[i]);
                     }
                 }
                 break;
         }
+    }
+
+    /*
+    Return all neighbors of a given vertex.
+    An edge that has the maximum or minimum weight is considered not exist.
+    */
+    std::vector<NumType> getNeighbors(const NumType v) const {
+        std::vector<NumType> res;
+        traverse(v, [&](const NumType to, const WeightType w) {
+            UNUSED(w);
+            res.push_back(to);
+        });
         return res;
     }
 
+    /*
+    Return the amount of vertices that are neighbors of both given vertices.
+    It is a popcount of the AND of two rows in the bitset storage.
+    */
+    NumType countCommonNeighbors(const NumType u, const NumType v) const {
+        if (type == BITSET) {
+            return popcountAnd(vertices[u].bits.data(), vertices[v].bits.data(), getWordCount());
+        }
+        std::vector<NumType> nu = getNeighbors(u), nv = getNeighbors(v), common;
+        std::sort(nu.begin(), nu.end());
+        std::sort(nv.begin(), nv.end());
+        std::set_intersection(nu.begin(), nu.end(), nv.begin(), nv.end(), std::back_inserter(common));
+        return (NumType)common.size();
+    }
+
+private:
+    // Return the amount of 64-bit words in a row of the bitset
+    NumType getWordCount() const noexcept {
+        return (vertices.size() + 63) / 64;
+    }
+
+    bool hasBit(const NumType from, const NumType to) const noexcept {
+        return (vertices[from].bits[to / 64] >> (to % 64)) & 1;
+    }
+
+    void setBit(const NumType from, const NumType to) noexcept {
+        if (from != to) {
+            vertices[from].bits[to / 64] |= (std::uint64_t)1 << (to % 64);
+        }
+    }
+
+    void clearBit(const NumType from, const NumType to) noexcept {
+        vertices[from].bits[to / 64] &= ~((std::uint64_t)1 << (to % 64));
+    }
+
 private:
     struct AdjVertex {
         NumType num;
@@ -155,6 +287,7 @@ private:
         Value val;
         std::list<AdjVertex> neighbors;  // Adjacency list
         std::vector<WeightType> weight;  // Adjacency matrix
+        std::vector<std::uint64_t> bits;  // Adjacency bitset
     };
 
     StorageType type;
@@ -162,6 +295,12 @@ private:
     std::vector<Vertex> vertices;
 };
 
+template<typename Value, typename Num, typename Weight>
+constexpr typename Graph<Value, Num, Weight>::WeightType Graph<Value, Num, Weight>::MAX_WEIGHT;
+
+template<typename Value, typename Num, typename Weight>
+constexpr typename Graph<Value, Num, Weight>::WeightType Graph<Value, Num, Weight>::MIN_WEIGHT;
+
 JUMBLE_NAMESPACE_END
 
 #endif
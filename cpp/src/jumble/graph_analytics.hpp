@@ -0,0 +1,335 @@
+#ifndef JUMBLE_GRAPH_ANALYTICS_HPP_INCLUDED
+#define JUMBLE_GRAPH_ANALYTICS_HPP_INCLUDED
+
+#include "jumble/csr_graph.hpp"
+#include "jumble/util/bitmap.hpp"
+#include "jumble/util/thread_pool.hpp"
+#include <vector>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <cmath>
+#include <cstdint>
+
+JUMBLE_NAMESPACE_BEGIN
+
+namespace detail {
+
+template<typename Num>
+using AtomicArray = std::unique_ptr<std::atomic<Num>[]>;
+
+/*
+One top-down step of the BFS: every vertex in the frontier
+claims its unvisited outgoing neighbors.
+
+@return The amount of outgoing edges of the next frontier
+*/
+template<typename Num, typename Weight>
+Num bfsTopDown(const BasicCSRGraph<Num, Weight>& graph, AtomicArray<Num>& parent,
+               std::vector<Num>& frontier, ThreadPool& pool) {
+    using NumType = Num;
+    const NumType none = graph.getSize() + 1;
+    std::vector<NumType> next;
+    NumType scout = 0;
+    std::mutex mtx;
+    pool.parallelFor(0, frontier.size(), [&](const std::size_t beg, const std::size_t end) {
+        std::vector<NumType> localNext;
+        NumType localScout = 0;
+        for (std::size_t i = beg; i < end; ++i) {
+            NumType u = frontier[i];
+            for (auto it = graph.neighborBegin(u); it != graph.neighborEnd(u); ++it) {
+                NumType v = *it;
+                NumType cur = parent[v].load(std::memory_order_relaxed);
+                if (cur == none && parent[v].compare_exchange_strong(cur, u)) {
+                    localNext.push_back(v);
+                    localScout += graph.getDegree(v);
+                }
+            }
+        }
+        std::lock_guard<std::mutex> lock(mtx);
+        next.insert(next.end(), localNext.begin(), localNext.end());
+        scout += localScout;
+    });
+    frontier.swap(next);
+    return scout;
+}
+
+/*
+One bottom-up step of the BFS: every unvisited vertex looks
+for a parent among its incoming neighbors in the frontier.
+
+@return The amount of vertices in the next frontier
+*/
+template<typename Num, typename Weight>
+Num bfsBottomUp(const BasicCSRGraph<Num, Weight>& transposed, AtomicArray<Num>& parent,
+                const Bitmap& front, Bitmap& next, ThreadPool& pool) {
+    using NumType = Num;
+    const NumType none = transposed.getSize() + 1;
+    std::atomic<NumType> awake(0);
+    next.clear();
+    pool.parallelFor(0, transposed.getSize(), [&](const NumType beg, const NumType end) {
+        NumType localAwake = 0;
+        for (NumType v = beg; v < end; ++v) {
+            if (parent[v].load(std::memory_order_relaxed) != none) {
+                continue;
+            }
+            for (auto it = transposed.neighborBegin(v); it != transposed.neighborEnd(v); ++it) {
+                if (front.get(*it)) {
+                    parent[v].store(*it, std::memory_order_relaxed);
+                    next.set(v);
+                    ++localAwake;
+                    break;
+                }
+            }
+        }
+        awake += localAwake;
+    });
+    return awake;
+}
+
+// Return the root of the tree containing vertex 'v'
+template<typename Num>
+Num ccFind(const AtomicArray<Num>& comp, Num v) noexcept {
+    Num p = comp[v].load(std::memory_order_relaxed);
+    while (p != v) {
+        v = p;
+        p = comp[v].load(std::memory_order_relaxed);
+    }
+    return v;
+}
+
+// Merge the trees containing vertex 'u' and 'v', always hooking the higher root to the lower one
+template<typename Num>
+void ccLink(AtomicArray<Num>& comp, const Num u, const Num v) noexcept {
+    Num p1 = comp[u].load(), p2 = comp[v].load();
+    while (p1 != p2) {
+        Num high = p1 > p2 ? p1 : p2;
+        Num low = p1 > p2 ? p2 : p1;
+        Num pHigh = comp[high].load();
+        if (pHigh == low || (pHigh == high && comp[high].compare_exchange_strong(pHigh, low))) {
+            break;
+        }
+        p1 = comp[comp[high].load()].load();
+        p2 = comp[low].load();
+    }
+}
+
+}  // namespace detail
+
+/*
+Direction-optimizing breadth-first search. It starts with top-down steps
+and switches to bottom-up steps (scanning unvisited vertices against a
+frontier bitmap) once the frontier becomes large, which avoids checking
+most edges of low-diameter graphs.
+Reference: Beamer et al., Direction-Optimizing Breadth-First Search, SC'12.
+
+@param graph      The graph
+@param transposed The graph with every edge reversed, see CSRGraph::transpose()
+@param src        The starting vertex number
+@param pool       The threads to run the search
+@return           The parent of each vertex in the BFS tree. The parent of 'src'
+                  is 'src' itself. The parent of an unreachable vertex is
+                  graph.getSize() + 1.
+*/
+template<typename Num, typename Weight>
+std::vector<Num> bfs(const BasicCSRGraph<Num, Weight>& graph,
+                     const BasicCSRGraph<Num, Weight>& transposed,
+                     const typename BasicCSRGraph<Num, Weight>::NumType src, ThreadPool& pool) {
+    using NumType = Num;
+    const NumType ALPHA = 15, BETA = 18;  // Heuristic switching parameters
+
+    const NumType n = graph.getSize();
+    const NumType none = n + 1;
+    detail::AtomicArray<NumType> parent(new std::atomic<NumType>[n]);
+    pool.parallelFor(0, n, [&](const NumType beg, const NumType end) {
+        for (NumType v = beg; v < end; ++v) {
+            parent[v].store(none, std::memory_order_relaxed);
+        }
+    });
+    parent[src].store(src);
+
+    std::vector<NumType> frontier(1, src);
+    Bitmap front(n), next(n);
+    NumType edgesToCheck = graph.getEdgeCount();
+    NumType scout = graph.getDegree(src);
+    while (!frontier.empty()) {
+        if (scout > edgesToCheck / ALPHA) {
+            front.clear();
+            for (const auto &v : frontier) {
+                front.set(v);
+            }
+            NumType awake = (NumType)frontier.size(), oldAwake;
+            do {
+                oldAwake = awake;
+                awake = detail::bfsBottomUp(transposed, parent, front, next, pool);
+                front.swap(next);
+            } while (awake >= oldAwake || awake > n / BETA);
+            frontier.clear();
+            for (NumType v = 0; v < n; ++v) {
+                if (front.get(v)) {
+                    frontier.push_back(v);
+                }
+            }
+            scout = 1;
+        } else {
+            edgesToCheck -= scout;
+            scout = detail::bfsTopDown(graph, parent, frontier, pool);
+        }
+    }
+
+    std::vector<NumType> res(n);
+    for (NumType v = 0; v < n; ++v) {
+        res[v] = parent[v].load(std::memory_order_relaxed);
+    }
+    return res;
+}
+
+/*
+Direction-optimizing breadth-first search.
+The transposed graph is built on every call.
+*/
+template<typename Num, typename Weight>
+std::vector<Num> bfs(const BasicCSRGraph<Num, Weight>& graph,
+                     const typename BasicCSRGraph<Num, Weight>::NumType src, ThreadPool& pool) {
+    return bfs(graph, graph.transpose(), src, pool);
+}
+
+/*
+Find the (weakly) connected components of a graph with a lock-free
+union-find: edges are linked in parallel by hooking the higher root
+to the lower one with CAS, then all paths are compressed.
+Reference: Sutton et al., Optimizing Parallel Graph Connectivity Computation
+via Subgraph Sampling, IPDPS'18.
+
+@param graph The graph. Edge directions are ignored.
+@param pool  The threads to run the algorithm
+@return      The component of each vertex, identified by the
+             smallest vertex number in the component
+*/
+template<typename Num, typename Weight>
+std::vector<Num> connectedComponents(const BasicCSRGraph<Num, Weight>& graph, ThreadPool& pool) {
+    using NumType = Num;
+
+    const NumType n = graph.getSize();
+    detail::AtomicArray<NumType> comp(new std::atomic<NumType>[n]);
+    pool.parallelFor(0, n, [&](const NumType beg, const NumType end) {
+        for (NumType v = beg; v < end; ++v) {
+            comp[v].store(v, std::memory_order_relaxed);
+        }
+    });
+    pool.parallelFor(0, n, [&](const NumType beg, const NumType end) {
+        for (NumType u = beg; u < end; ++u) {
+            for (auto it = graph.neighborBegin(u); it != graph.neighborEnd(u); ++it) {
+                detail::ccLink(comp, u, *it);
+            }
+        }
+    });
+
+    std::vector<NumType> res(n);
+    pool.parallelFor(0, n, [&](const NumType beg, const NumType end) {
+        for (NumType v = beg; v < end; ++v) {
+            res[v] = detail::ccFind(comp, v);
+        }
+    });
+    return res;
+}
+
+/*
+Compute the PageRank of each vertex with pull-based power iteration.
+The rank of dangling vertices (without outgoing edges) is spread evenly.
+
+@param graph     The graph
+@param pool      The threads to run the algorithm
+@param damping   The damping factor
+@param tolerance Stop when the L1 norm of the rank change is below it
+@param maxIter   The maximum amount of iterations
+@return          The rank of each vertex, summing up to one
+*/
+template<typename Num, typename Weight>
+std::vector<double> pageRank(const BasicCSRGraph<Num, Weight>& graph, ThreadPool& pool,
+                             const double damping = 0.85,
+                             const double tolerance = 1e-6,
+                             const std::size_t maxIter = 100) {
+    using NumType = Num;
+
+    const NumType n = graph.getSize();
+    if (n == 0) {
+        return std::vector<double>();
+    }
+    const BasicCSRGraph<Num, Weight> transposed = graph.transpose();
+    std::vector<double> rank(n, 1.0 / n), next(n), contrib(n);
+    std::mutex mtx;
+    for (std::size_t iter = 0; iter < maxIter; ++iter) {
+        double dangling = 0;
+        pool.parallelFor(0, n, [&](const NumType beg, const NumType end) {
+            double localDangling = 0;
+            for (NumType v = beg; v < end; ++v) {
+                NumType deg = graph.getDegree(v);
+                if (deg) {
+                    contrib[v] = rank[v] / deg;
+                } else {
+                    contrib[v] = 0;
+                    localDangling += rank[v];
+                }
+            }
+            std::lock_guard<std::mutex> lock(mtx);
+            dangling += localDangling;
+        });
+
+        const double base = (1 - damping) / n + damping * dangling / n;
+        double error = 0;
+        pool.parallelFor(0, n, [&](const NumType beg, const NumType end) {
+            double localError = 0;
+            for (NumType v = beg; v < end; ++v) {
+                double sum = 0;
+                for (auto it = transposed.neighborBegin(v); it != transposed.neighborEnd(v); ++it) {
+                    sum += contrib[*it];
+                }
+                next[v] = base + damping * sum;
+                localError += std::fabs(next[v] - rank[v]);
+            }
+            std::lock_guard<std::mutex> lock(mtx);
+            error += localError;
+        });
+
+        rank.swap(next);
+        if (error < tolerance) {
+            break;
+        }
+    }
+    return rank;
+}
+
+/*
+Count the triangles in an undirected graph, i.e. the sum of common
+neighbors over all edges divided by three. It is fastest with the
+BITSET storage, where each edge costs one AND-popcount of two rows.
+
+@param graph The graph. Each edge must be stored in both directions.
+@param pool  The threads to run the algorithm
+@return      The amount of triangles
+*/
+template<typename Value, typename Num, typename Weight>
+std::uint64_t countTriangles(const Graph<Value, Num, Weight>& graph, ThreadPool& pool) {
+    using NumType = Num;
+    using WeightType = Weight;
+
+    std::atomic<std::uint64_t> total(0);
+    pool.parallelFor(0, graph.getSize(), [&](const NumType beg, const NumType end) {
+        std::uint64_t local = 0;
+        for (NumType u = beg; u < end; ++u) {
+            graph.traverse(u, [&](const NumType v, const WeightType w) {
+                UNUSED(w);
+                if (u < v) {
+                    local += graph.countCommonNeighbors(u, v);
+                }
+            });
+        }
+        total += local;
+    });
+    return total / 3;
+}
+
+JUMBLE_NAMESPACE_END
+
+#endif
@@ -0,0 +1,285 @@
+#ifndef JUMBLE_GRAPH_FILE_HPP_INCLUDED
+#define JUMBLE_GRAPH_FILE_HPP_INCLUDED
+
+#include "jumble/csr_graph.hpp"
+#include "jumble/util/mapped_file.hpp"
+#include <string>
+#include <vector>
+#include <memory>
+#include <fstream>
+#include <stdexcept>
+#include <type_traits>
+#include <limits>
+#include <cstring>
+#include <cstdint>
+
+JUMBLE_NAMESPACE_BEGIN
+
+/*
+Binary file format of a graph, which is written once and then mapped
+into memory to be used without parsing or copying.
+
+All numbers are stored in native byte order. The file consists of:
+1. A 64-byte header (see GraphFile::Header).
+2. The CSR offsets array, (#vertices + 1) elements of NumType.
+3. The CSR targets array, #edges elements of NumType.
+4. The CSR weights array, #edges elements of WeightType.
+5. The vertex values, #vertices elements of the value type.
+Each section starts at an offset aligned to 8 bytes.
+*/
+class GraphFile {
+public:
+    static const std::uint32_t VERSION = 1;
+
+    // Kind of the weight type
+    enum WeightKind {
+        SIGNED_INT,
+        UNSIGNED_INT,
+        FLOATING
+    };
+
+    struct Header {
+        char magic[8];
+        std::uint32_t version;
+        std::uint32_t byteOrder;   // ENDIAN_MARK in the writer's byte order
+        std::uint32_t numSize;     // sizeof(NumType)
+        std::uint32_t weightSize;  // sizeof(WeightType)
+        std::uint32_t valueSize;   // sizeof(Value)
+        std::uint32_t weightKind;  // WeightKind of WeightType
+        std::uint64_t vertexCount;
+        std::uint64_t edgeCount;
+        std::uint64_t reserved[2];
+    };
+
+    /*
+    Write a graph and its vertex values to a file.
+
+    @param path   The path of the file
+    @param graph  The graph
+    @param values The value of each vertex, graph.getSize() elements
+    @throw std::runtime_error if the file cannot be written
+    */
+    template<typename Value, typename Num, typename Weight>
+    static void write(const std::string& path, const BasicCSRGraph<Num, Weight>& graph,
+                      const Value *const values) {
+        using NumType = Num;
+        using WeightType = Weight;
+        checkValueType<Value>();
+
+        Header header;
+        std::memset(&header, 0, sizeof(header));
+        std::memcpy(header.magic, MAGIC, sizeof(header.magic));
+        header.version = VERSION;
+        header.byteOrder = ENDIAN_MARK;
+        header.numSize = sizeof(NumType);
+        header.weightSize = sizeof(WeightType);
+        header.valueSize = sizeof(Value);
+        header.weightKind = weightKind<WeightType>();
+        header.vertexCount = graph.getSize();
+        header.edgeCount = graph.getEdgeCount();
+
+        std::ofstream ofs(path, std::ios::binary | std::ios::trunc);
+        if (!ofs) {
+            throw std::runtime_error("cannot open " + path);
+        }
+        NumType n = graph.getSize();
+        writeSection(ofs, &header, sizeof(header));
+        std::vector<NumType> offsets(n + 1);
+        for (NumType v = 0; v < n; ++v) {
+            offsets[v + 1] = offsets[v] + graph.getDegree(v);
+        }
+        writeSection(ofs, offsets.data(), offsets.size() * sizeof(NumType));
+        writeSection(ofs, graph.neighborBegin(0), graph.getEdgeCount() * sizeof(NumType));
+        writeSection(ofs, graph.weightBegin(0), graph.getEdgeCount() * sizeof(WeightType));
+        writeSection(ofs, values, n * sizeof(Value));
+        if (!ofs.flush()) {
+            throw std::runtime_error("cannot write " + path);
+        }
+    }
+
+    /*
+    Write a Graph object to a file.
+
+    @param path  The path of the file
+    @param graph The graph object in either storage type
+    @throw std::runtime_error if the file cannot be written
+    */
+    template<typename Value, typename Num, typename Weight>
+    static void write(const std::string& path, const Graph<Value, Num, Weight>& graph) {
+        std::vector<Value> values;
+        values.reserve(graph.getSize());
+        for (Num v = 0; v < graph.getSize(); ++v) {
+            values.push_back(graph[v]);
+        }
+        write(path, BasicCSRGraph<Num, Weight>(graph), values.data());
+    }
+
+private:
+    template<typename Value, typename Num, typename Weight>
+    friend class MappedGraph;
+
+    static constexpr const char *MAGIC = "JMBGRAPH";
+    static const std::uint32_t ENDIAN_MARK = 0x01020304;
+    static const std::size_t ALIGNMENT = 8;
+
+    template<typename Value>
+    static void checkValueType() {
+        static_assert(std::is_trivially_copyable<Value>::value,
+                      "vertex values must be trivially copyable");
+        static_assert(alignof(Value) <= ALIGNMENT,
+                      "vertex values must not be over-aligned");
+    }
+
+    template<typename Weight>
+    static std::uint32_t weightKind() noexcept {
+        return !std::numeric_limits<Weight>::is_integer ? FLOATING
+            : std::numeric_limits<Weight>::is_signed ? SIGNED_INT : UNSIGNED_INT;
+    }
+
+    // Return the smallest offset no less than 'off' that is aligned
+    static std::uint64_t align(const std::uint64_t off) noexcept {
+        return (off + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+    }
+
+    // Pad the stream to the alignment and write 'len' bytes
+    static void writeSection(std::ofstream& ofs, const void *const data, const std::size_t len) {
+        static const char zeros[ALIGNMENT] = {0};
+        std::uint64_t pos = (std::uint64_t)ofs.tellp();
+        ofs.write(zeros, (std::streamsize)(align(pos) - pos));
+        if (len) {
+            ofs.write(static_cast<const char*>(data), (std::streamsize)len);
+        }
+    }
+};
+
+
+/*
+A graph file mapped into memory. The graph arrays and vertex values
+are used in place, so opening a file costs only a few system calls
+regardless of its size.
+
+@param Value  The type of the values stored in each vertex
+@param Num    The type of vertex numbers, see Graph
+@param Weight The type of edge weights, see Graph
+*/
+template<typename Value, typename Num = std::size_t, typename Weight = std::int32_t>
+class MappedGraph {
+public:
+    using NumType = Num;
+    using WeightType = Weight;
+    using GraphType = BasicCSRGraph<NumType, WeightType>;
+
+    /*
+    Map a graph file written by GraphFile::write(). The header and the
+    CSR arrays are validated by a linear scan of the offsets and targets,
+    so a corrupt file cannot cause reads out of the mapping.
+
+    @param path The path of the file
+    @throw std::runtime_error if the file cannot be mapped or is invalid
+    */
+    explicit MappedGraph(const std::string& path) {
+        GraphFile::checkValueType<Value>();
+
+        auto file = std::make_shared<MappedFile>(path);
+        GraphFile::Header header;
+        if (file->getSize() < sizeof(header)) {
+            throw std::runtime_error("truncated graph file " + path);
+        }
+        std::memcpy(&header, file->data(), sizeof(header));
+        if (std::memcmp(header.magic, GraphFile::MAGIC, sizeof(header.magic)) != 0) {
+            throw std::runtime_error("not a graph file " + path);
+        }
+        if (header.version != GraphFile::VERSION) {
+            throw std::runtime_error("unsupported graph file version " + std::to_string(header.version));
+        }
+        if (header.byteOrder != GraphFile::ENDIAN_MARK || header.numSize != sizeof(NumType)
+            || header.weightSize != sizeof(WeightType) || header.valueSize != sizeof(Value)
+            || header.weightKind != GraphFile::weightKind<WeightType>()) {
+            throw std::runtime_error("incompatible graph file " + path);
+        }
+
+        std::uint64_t n = header.vertexCount, m = header.edgeCount;
+        if (n >= (std::uint64_t)std::numeric_limits<NumType>::max()
+            || m > (std::uint64_t)std::numeric_limits<NumType>::max()) {
+            throw std::runtime_error("invalid graph file " + path);
+        }
+        // Each section is checked against the file size before the next one
+        // is located, so a huge count cannot wrap the offsets around
+        std::uint64_t size = file->getSize();
+        std::uint64_t offsetsOff = GraphFile::align(sizeof(header));
+        std::uint64_t targetsOff = GraphFile::align(sectionEnd(offsetsOff, n + 1, sizeof(NumType), size, path));
+        std::uint64_t weightsOff = GraphFile::align(sectionEnd(targetsOff, m, sizeof(NumType), size, path));
+        std::uint64_t valuesOff = GraphFile::align(sectionEnd(weightsOff, m, sizeof(WeightType), size, path));
+        sectionEnd(valuesOff, n, sizeof(Value), size, path);
+
+        const unsigned char *base = file->data();
+        const NumType *offsets = reinterpret_cast<const NumType*>(base + offsetsOff);
+        const NumType *targets = reinterpret_cast<const NumType*>(base + targetsOff);
+        checkArrays(offsets, targets, (NumType)n, (NumType)m, path);
+        values = reinterpret_cast<const Value*>(base + valuesOff);
+        graph = GraphType((NumType)n, offsets, targets,
+                         reinterpret_cast<const WeightType*>(base + weightsOff),
+                         std::move(file));
+    }
+
+    // Return the graph. It stays valid after this object is destroyed.
+    const GraphType& getGraph() const noexcept {
+        return graph;
+    }
+
+    // Return the amount of vertices in the graph
+    NumType getSize() const noexcept {
+        return graph.getSize();
+    }
+
+    // Return the value of a given vertex
+    const Value& operator[](const NumType v) const noexcept {
+        return values[v];
+    }
+
+private:
+    /*
+    Return the end of a section, which must lie within the file.
+
+    @param off      The offset of the section
+    @param count    The amount of elements
+    @param elemSize The size of an element
+    @param size     The size of the file
+    @param path     The path of the file, for the error message
+    @throw std::runtime_error if the section exceeds the file
+    */
+    static std::uint64_t sectionEnd(const std::uint64_t off, const std::uint64_t count,
+                                    const std::uint64_t elemSize, const std::uint64_t size,
+                                    const std::string& path) {
+        if (off > size || count > (size - off) / elemSize) {
+            throw std::runtime_error("truncated graph file " + path);
+        }
+        return off + count * elemSize;
+    }
+
+    // Check that the offsets ascend from 0 to m and every target is a vertex
+    static void checkArrays(const NumType *const offsets, const NumType *const targets,
+                            const NumType n, const NumType m, const std::string& path) {
+        if (offsets[0] != 0 || offsets[n] != m) {
+            throw std::runtime_error("invalid offsets in graph file " + path);
+        }
+        for (NumType v = 0; v < n; ++v) {
+            if (offsets[v] > offsets[v + 1]) {
+                throw std::runtime_error("invalid offsets in graph file " + path);
+            }
+        }
+        for (NumType i = 0; i < m; ++i) {
+            if (targets[i] >= n) {
+                throw std::runtime_error("invalid edge target in graph file " + path);
+            }
+        }
+    }
+
+private:
+    GraphType graph;
+    const Value *values = nullptr;
+};
+
+JUMBLE_NAMESPACE_END
+
+#endif
@@ -0,0 +1,163 @@
+#ifndef JUMBLE_GRID_PATH_HPP_INCLUDED
+#define JUMBLE_GRID_PATH_HPP_INCLUDED
+
+#include "jumble/astar.hpp"
+#include <vector>
+#include <string>
+#include <functional>
+#include <stdexcept>
+#include <cstddef>
+#include <cstdint>
+
+JUMBLE_NAMESPACE_BEGIN
+
+/*
+A grid map with blocked cells, on which shortest paths are found by
+A* search. Moves go to the four adjacent cells with cost one, so the
+Manhattan distance is an exact estimate on open ground, and the open
+list is a bucket queue. A state is the index of a cell (row * #cols + col).
+*/
+class GridMap {
+public:
+    using SizeType = std::size_t;
+
+    struct Cell {
+        SizeType row;
+        SizeType col;
+
+        bool operator==(const Cell& c) const noexcept {
+            return row == c.row && col == c.col;
+        }
+
+        bool operator!=(const Cell& c) const noexcept {
+            return !(*this == c);
+        }
+    };
+
+private:
+    using State = std::uint32_t;
+
+    // The free cells adjacent to a cell
+    struct Expander {
+        const GridMap *map;
+
+        template<typename Emit>
+        void operator()(const State s, Emit&& emit) const {
+            SizeType r = s / map->cols, c = s % map->cols;
+            if (c > 0 && !map->blocked[s - 1]) {
+                emit(s - 1, 1);
+            }
+            if (r > 0 && !map->blocked[s - map->cols]) {
+                emit((State)(s - map->cols), 1);
+            }
+            if (c + 1 < map->cols && !map->blocked[s + 1]) {
+                emit(s + 1, 1);
+            }
+            if (r + 1 < map->rows && !map->blocked[s + map->cols]) {
+                emit((State)(s + map->cols), 1);
+            }
+        }
+    };
+
+    // The Manhattan distance to the ending cell
+    struct Estimator {
+        const GridMap *map;
+        Cell goal;
+
+        std::uint32_t operator()(const State s) const noexcept {
+            SizeType r = s / map->cols, c = s % map->cols;
+            return (std::uint32_t)((r > goal.row ? r - goal.row : goal.row - r)
+                                   + (c > goal.col ? c - goal.col : goal.col - c));
+        }
+    };
+
+    using Engine = AStar<State, Expander, Estimator, std::hash<State>, std::equal_to<State>, BucketOpenList>;
+
+public:
+    using Stats = Engine::Stats;
+
+    /*
+    Initialize the map.
+
+    @param rows_ The rows of the map, in which '#' denotes a blocked cell
+                 and any other character a free cell
+    @throw std::invalid_argument if the map is empty or the rows have
+           different lengths
+    */
+    explicit GridMap(const std::vector<std::string>& rows_)
+        : rows(rows_.size()), cols(rows_.empty() ? 0 : rows_[0].size()) {
+        if (rows == 0 || cols == 0) {
+            throw std::invalid_argument("empty grid map");
+        }
+        blocked.reserve(rows * cols);
+        for (const auto &r : rows_) {
+            if (r.size() != cols) {
+                throw std::invalid_argument("grid map rows have different lengths");
+            }
+            for (char c : r) {
+                blocked.push_back(c == '#');
+            }
+        }
+    }
+
+    SizeType getRowCount() const noexcept {
+        return rows;
+    }
+
+    SizeType getColCount() const noexcept {
+        return cols;
+    }
+
+    // Return true if a given cell is blocked
+    bool isBlocked(const Cell& c) const noexcept {
+        return blocked[c.row * cols + c.col] != 0;
+    }
+
+    /*
+    Find a shortest path between two cells.
+
+    @param from The beginning cell
+    @param to   The ending cell
+    @return     The cells of the path including both ends, empty if
+                either cell is blocked or no path exists
+    @throw std::out_of_range if a cell is outside the map
+    */
+    std::vector<Cell> findPath(const Cell& from, const Cell& to) {
+        if (from.row >= rows || from.col >= cols || to.row >= rows || to.col >= cols) {
+            throw std::out_of_range("cell outside the grid map");
+        }
+        std::vector<Cell> res;
+        engine.clear();
+        if (isBlocked(from) || isBlocked(to)) {
+            return res;
+        }
+        engine.getExpand() = Expander{this};
+        engine.getHeuristic() = Estimator{this, to};
+        if (engine.search(index(from), index(to))) {
+            for (auto s : engine.getPath()) {
+                res.push_back({s / cols, s % cols});
+            }
+        }
+        return res;
+    }
+
+    // Return the counters of the last search, see AStar::Stats
+    const Stats& getStats() const noexcept {
+        return engine.getStats();
+    }
+
+private:
+    State index(const Cell& c) const noexcept {
+        return (State)(c.row * cols + c.col);
+    }
+
+private:
+    SizeType rows;
+    SizeType cols;
+    std::vector<std::uint8_t> blocked;
+    Engine engine;
+};
+
+JUMBLE_NAMESPACE_END
+
+#endif
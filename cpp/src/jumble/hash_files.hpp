@@ -0,0 +1,42 @@
+#ifndef JUMBLE_HASH_FILES_HPP_INCLUDED
+#define JUMBLE_HASH_FILES_HPP_INCLUDED
+
+#include "jumble/md5.hpp"
+#include "jumble/util/thread_pool.hpp"
+#include "jumble/util/mapped_file.hpp"
+#include "jumble/util/hex.hpp"
+#include <string>
+#include <vector>
+#include <cstddef>
+
+JUMBLE_NAMESPACE_BEGIN
+
+/*
+Hash files in parallel. Each file is mapped into memory and hashed
+by one worker thread.
+
+@param Context The digest, with the interface of MD5Context
+@param paths   The paths of the files
+@param pool    The threads to hash the files
+@return        The digests in hexadecimal in the order of the paths
+@throw std::runtime_error if a file cannot be read
+*/
+template<typename Context = MD5Context>
+std::vector<std::string> hashFiles(const std::vector<std::string>& paths, ThreadPool& pool) {
+    std::vector<std::string> res(paths.size(), std::string(Context::DIGEST_SIZE * 2, '0'));
+    pool.parallelFor(0, paths.size(), [&paths, &res](const std::size_t beg, const std::size_t end) {
+        unsigned char digest[Context::DIGEST_SIZE];
+        for (std::size_t i = beg; i < end; ++i) {
+            MappedFile file(paths[i]);
+            Context ctx;
+            ctx.update(file.data(), file.getSize());
+            ctx.finalize(digest);
+            toHex(digest, Context::DIGEST_SIZE, &res[i][0]);
+        }
+    });
+    return res;
+}
+
+JUMBLE_NAMESPACE_END
+
+#endif
@@ -2,6 +2,7 @@
 #define JUMBLE_HASH_TABLE_HPP_INCLUDED
 
 #include "jumble/doubly_linked_list.hpp"
+#include "jumble/xxhash.hpp"
 #include <vector>
 #include <utility>
 
@@ -17,9 +18,11 @@ their values.
                 If PredCmp(a, b) == true, then value 'a' and value 'b' are
                 considered equal.
 @param Hash  A unary functor that computes the hash value of an element.
+             The bucket is chosen by the low bits of the hash value, see
+             FastHash for why it is the default.
 */
 template<typename Value, typename PredCmp = std::equal_to<Value>,
-         typename Hash = std::hash<Value>>
+         typename Hash = FastHash<Value>>
 class HashTable {
 public:
     using SizeType = std::size_t;
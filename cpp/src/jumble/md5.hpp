@@ -2,178 +2,392 @@
 #define JUMBLE_MD5_HPP_INCLUDED
 
 #include "jumble/util/common.hpp"
+#include "jumble/util/hex.hpp"
 #include <string>
-#include <vector>
+#include <cstring>
+#include <cstddef>
 #include <cstdint>
 
 JUMBLE_NAMESPACE_BEGIN
 
-class MD5 {
+/*
+The MD5 compression function upon any type of words, e.g. one 32-bit
+integer, or a SIMD vector holding one word of each of several messages.
+The 64 steps are unrolled with their message indices, shift counts and
+constants as immediates, so there are no branches and no table lookups.
+
+@param Ops A type providing the word type Word and the operations on
+           words: set(k) making a word of a constant, add(a, b),
+           bitAnd(a, b), bitXor(a, b), andNot(a, b) = ~a & b,
+           orNot(a, b) = a | ~b, and rotate<S>(a) = a <<< S
+*/
+template<typename Ops>
+class MD5Compression {
+public:
+    using Word = typename Ops::Word;
+    using UInt32 = std::uint32_t;
+
+    /*
+    Process one block.
+
+    @param state The four words a, b, c and d of the digest
+    @param x     The 16 little-endian words of the block
+    */
+    static void run(Word (&state)[4], const Word (&x)[16]) noexcept {
+        Word a = state[0], b = state[1], c = state[2], d = state[3];
+
+        roundF<7>(a, b, c, d, x[0], 0xd76aa478);
+        roundF<12>(d, a, b, c, x[1], 0xe8c7b756);
+        roundF<17>(c, d, a, b, x[2], 0x242070db);
+        roundF<22>(b, c, d, a, x[3], 0xc1bdceee);
+        roundF<7>(a, b, c, d, x[4], 0xf57c0faf);
+        roundF<12>(d, a, b, c, x[5], 0x4787c62a);
+        roundF<17>(c, d, a, b, x[6], 0xa8304613);
+        roundF<22>(b, c, d, a, x[7], 0xfd469501);
+        roundF<7>(a, b, c, d, x[8], 0x698098d8);
+        roundF<12>(d, a, b, c, x[9], 0x8b44f7af);
+        roundF<17>(c, d, a, b, x[10], 0xffff5bb1);
+        roundF<22>(b, c, d, a, x[11], 0x895cd7be);
+        roundF<7>(a, b, c, d, x[12], 0x6b901122);
+        roundF<12>(d, a, b, c, x[13], 0xfd987193);
+        roundF<17>(c, d, a, b, x[14], 0xa679438e);
+        roundF<22>(b, c, d, a, x[15], 0x49b40821);
+
+        roundG<5>(a, b, c, d, x[1], 0xf61e2562);
+        roundG<9>(d, a, b, c, x[6], 0xc040b340);
+        roundG<14>(c, d, a, b, x[11], 0x265e5a51);
+        roundG<20>(b, c, d, a, x[0], 0xe9b6c7aa);
+        roundG<5>(a, b, c, d, x[5], 0xd62f105d);
+        roundG<9>(d, a, b, c, x[10], 0x02441453);
+        roundG<14>(c, d, a, b, x[15], 0xd8a1e681);
+        roundG<20>(b, c, d, a, x[4], 0xe7d3fbc8);
+        roundG<5>(a, b, c, d, x[9], 0x21e1cde6);
+        roundG<9>(d, a, b, c, x[14], 0xc33707d6);
+        roundG<14>(c, d, a, b, x[3], 0xf4d50d87);
+        roundG<20>(b, c, d, a, x[8], 0x455a14ed);
+        roundG<5>(a, b, c, d, x[13], 0xa9e3e905);
+        roundG<9>(d, a, b, c, x[2], 0xfcefa3f8);
+        roundG<14>(c, d, a, b, x[7], 0x676f02d9);
+        roundG<20>(b, c, d, a, x[12], 0x8d2a4c8a);
+
+        roundH<4>(a, b, c, d, x[5], 0xfffa3942);
+        roundH<11>(d, a, b, c, x[8], 0x8771f681);
+        roundH<16>(c, d, a, b, x[11], 0x6d9d6122);
+        roundH<23>(b, c, d, a, x[14], 0xfde5380c);
+        roundH<4>(a, b, c, d, x[1], 0xa4beea44);
+        roundH<11>(d, a, b, c, x[4], 0x4bdecfa9);
+        roundH<16>(c, d, a, b, x[7], 0xf6bb4b60);
+        roundH<23>(b, c, d, a, x[10], 0xbebfbc70);
+        roundH<4>(a, b, c, d, x[13], 0x289b7ec6);
+        roundH<11>(d, a, b, c, x[0], 0xeaa127fa);
+        roundH<16>(c, d, a, b, x[3], 0xd4ef3085);
+        roundH<23>(b, c, d, a, x[6], 0x04881d05);
+        roundH<4>(a, b, c, d, x[9], 0xd9d4d039);
+        roundH<11>(d, a, b, c, x[12], 0xe6db99e5);
+        roundH<16>(c, d, a, b, x[15], 0x1fa27cf8);
+        roundH<23>(b, c, d, a, x[2], 0xc4ac5665);
+
+        roundI<6>(a, b, c, d, x[0], 0xf4292244);
+        roundI<10>(d, a, b, c, x[7], 0x432aff97);
+        roundI<15>(c, d, a, b, x[14], 0xab9423a7);
+        roundI<21>(b, c, d, a, x[5], 0xfc93a039);
+        roundI<6>(a, b, c, d, x[12], 0x655b59c3);
+        roundI<10>(d, a, b, c, x[3], 0x8f0ccc92);
+        roundI<15>(c, d, a, b, x[10], 0xffeff47d);
+        roundI<21>(b, c, d, a, x[1], 0x85845dd1);
+        roundI<6>(a, b, c, d, x[8], 0x6fa87e4f);
+        roundI<10>(d, a, b, c, x[15], 0xfe2ce6e0);
+        roundI<15>(c, d, a, b, x[6], 0xa3014314);
+        roundI<21>(b, c, d, a, x[13], 0x4e0811a1);
+        roundI<6>(a, b, c, d, x[4], 0xf7537e82);
+        roundI<10>(d, a, b, c, x[11], 0xbd3af235);
+        roundI<15>(c, d, a, b, x[2], 0x2ad7d2bb);
+        roundI<21>(b, c, d, a, x[9], 0xeb86d391);
+
+        state[0] = Ops::add(state[0], a);
+        state[1] = Ops::add(state[1], b);
+        state[2] = Ops::add(state[2], c);
+        state[3] = Ops::add(state[3], d);
+    }
+
+private:
+    /*
+    One step of each round, a = b + ((a + f(b, c, d) + x + k) <<< S),
+    where f is the round function. a + x + k doesn't depend on the last
+    step, so it is added first to shorten the dependency chain. F takes
+    one operation fewer than (b & c) | (~b & d), and G adds its two
+    disjoint halves instead of or-ing them, so they are added separately.
+
+    @param a/b/c/d The four words of the digest, rotated by the step
+    @param x       The message word
+    @param k       The constant of the step
+    */
+    template<int S>
+    static void roundF(Word& a, const Word b, const Word c, const Word d,
+                       const Word x, const UInt32 k) noexcept {
+        Word f = Ops::bitXor(d, Ops::bitAnd(b, Ops::bitXor(c, d)));
+        a = Ops::add(b, Ops::template rotate<S>(Ops::add(Ops::add(Ops::add(a, x), Ops::set(k)), f)));
+    }
+
+    template<int S>
+    static void roundG(Word& a, const Word b, const Word c, const Word d,
+                       const Word x, const UInt32 k) noexcept {
+        Word t = Ops::add(Ops::add(Ops::add(a, x), Ops::set(k)), Ops::bitAnd(d, b));
+        a = Ops::add(b, Ops::template rotate<S>(Ops::add(t, Ops::andNot(d, c))));
+    }
+
+    template<int S>
+    static void roundH(Word& a, const Word b, const Word c, const Word d,
+                       const Word x, const UInt32 k) noexcept {
+        Word h = Ops::bitXor(Ops::bitXor(b, c), d);
+        a = Ops::add(b, Ops::template rotate<S>(Ops::add(Ops::add(Ops::add(a, x), Ops::set(k)), h)));
+    }
+
+    template<int S>
+    static void roundI(Word& a, const Word b, const Word c, const Word d,
+                       const Word x, const UInt32 k) noexcept {
+        Word i = Ops::bitXor(c, Ops::orNot(b, d));
+        a = Ops::add(b, Ops::template rotate<S>(Ops::add(Ops::add(Ops::add(a, x), Ops::set(k)), i)));
+    }
+};
+
+// Operations on one 32-bit word, see MD5Compression
+struct MD5ScalarOps {
+    using Word = std::uint32_t;
+
+    static Word set(const std::uint32_t k) noexcept {
+        return k;
+    }
+
+    static Word add(const Word a, const Word b) noexcept {
+        return a + b;
+    }
+
+    static Word bitAnd(const Word a, const Word b) noexcept {
+        return a & b;
+    }
+
+    static Word bitXor(const Word a, const Word b) noexcept {
+        return a ^ b;
+    }
+
+    static Word andNot(const Word a, const Word b) noexcept {
+        return ~a & b;
+    }
+
+    static Word orNot(const Word a, const Word b) noexcept {
+        return a | ~b;
+    }
+
+    template<int S>
+    static Word rotate(const Word a) noexcept {
+        return (a << S) | (a >> (32 - S));
+    }
+};
+
+/*
+An incremental MD5 computation. The message is given piece by piece
+with update(), and complete 64-byte blocks are processed in place, so
+only a partial block is buffered however long the message is.
+*/
+class MD5Context {
 public:
     using UInt32 = std::uint32_t;
     using UInt64 = std::uint64_t;
+    using SizeType = std::size_t;
 
-    // Forbid copy
-    MD5(const MD5&) = delete;
-    MD5& operator=(const MD5&) = delete;
+    static const SizeType BLOCK_SIZE = 64;
+    static const SizeType DIGEST_SIZE = 16;
 
-    // Forbid move
-    MD5(MD5&&) = delete;
-    MD5& operator=(MD5&&) = delete;
+    MD5Context() noexcept {
+        reset();
+    }
 
-    // Return the singleton instance
-    static MD5* getInstance() {
-        static MD5 instance;
-        return &instance;
+    // Start a new message
+    void reset() noexcept {
+        state[0] = 0x67452301;
+        state[1] = 0xefcdab89;
+        state[2] = 0x98badcfe;
+        state[3] = 0x10325476;
+        total = 0;
+        used = 0;
     }
 
     /*
-    Hash a message.
+    Append data to the message.
 
-    @param msg The message to be hashed
-    @return    The hashed string result
+    @param data The data
+    @param len  The amount of bytes
     */
-    std::string hash(const std::string& msg) {
-        UInt32 a = 0x67452301, b = 0xefcdab89;
-        UInt32 c = 0x98badcfe, d = 0x10325476;
-        UInt32 groupNum = 0;
-        UInt32 *str = pad(msg, groupNum);
-        for (UInt32 i = 0; i < groupNum; ++i) {
-            UInt32 group[16];  // Each group contains 16 32-bit intergers
-            for (int j = 0; j < 16; ++j) {
-                group[j] = str[(i << 4) + j];
+    void update(const void *const data, SizeType len) noexcept {
+        const unsigned char *p = static_cast<const unsigned char*>(data);
+        total += len;
+        if (used) {
+            SizeType n = BLOCK_SIZE - used < len ? BLOCK_SIZE - used : len;
+            std::memcpy(buffer + used, p, n);
+            used += n;
+            p += n;
+            len -= n;
+            if (used < BLOCK_SIZE) {
+                return;
             }
-            loop(group, a, b, c, d);
+            process(buffer, 1);
+            used = 0;
+        }
+        if (len >= BLOCK_SIZE) {
+            process(p, len / BLOCK_SIZE);
+            p += len / BLOCK_SIZE * BLOCK_SIZE;
+            len %= BLOCK_SIZE;
+        }
+        if (len) {
+            std::memcpy(buffer, p, len);
+            used = len;
         }
-        delete str;
-        return toHexStr(a) + toHexStr(b) + toHexStr(c) + toHexStr(d);
     }
 
-private:
-    // Default ctor
-    MD5() : hex("0123456789abcdef"), s({
-        7, 12, 17, 22, 7, 12, 17, 22, 7, 12, 17, 22, 7, 12, 17, 22,
-        5,  9, 14, 20, 5,  9, 14, 20, 5,  9, 14, 20, 5,  9, 14, 20,
-        4, 11, 16, 23, 4, 11, 16, 23, 4, 11, 16, 23, 4, 11, 16, 23,
-        6, 10, 15, 21, 6, 10, 15, 21, 6, 10, 15, 21, 6, 10, 15, 21
-    }), k({
-        0xd76aa478, 0xe8c7b756, 0x242070db, 0xc1bdceee, 0xf57c0faf, 0x4787c62a, 0xa8304613, 0xfd469501,
-        0x698098d8, 0x8b44f7af, 0xffff5bb1, 0x895cd7be, 0x6b901122, 0xfd987193, 0xa679438e, 0x49b40821,
-        0xf61e2562, 0xc040b340, 0x265e5a51, 0xe9b6c7aa, 0xd62f105d, 0x02441453, 0xd8a1e681, 0xe7d3fbc8,
-        0x21e1cde6, 0xc33707d6, 0xf4d50d87, 0x455a14ed, 0xa9e3e905, 0xfcefa3f8, 0x676f02d9, 0x8d2a4c8a,
-        0xfffa3942, 0x8771f681, 0x6d9d6122, 0xfde5380c, 0xa4beea44, 0x4bdecfa9, 0xf6bb4b60, 0xbebfbc70,
-        0x289b7ec6, 0xeaa127fa, 0xd4ef3085, 0x04881d05, 0xd9d4d039, 0xe6db99e5, 0x1fa27cf8, 0xc4ac5665,
-        0xf4292244, 0x432aff97, 0xab9423a7, 0xfc93a039, 0x655b59c3, 0x8f0ccc92, 0xffeff47d, 0x85845dd1,
-        0x6fa87e4f, 0xfe2ce6e0, 0xa3014314, 0x4e0811a1, 0xf7537e82, 0xbd3af235, 0x2ad7d2bb, 0xeb86d391
-    }) {}
-
     /*
-    Pad the string to make the length of the string satisfy: #(length) mod 512 = 0.
-    The last 64 bits of the result is #(length of the original string) mod 2^64.
+    Finish the message and start a new one.
 
-    @param str      The string to be filled up
-    @param groupNum The number of the groups
-    @return         The filled string stored in an array of 32-bit integer.
+    @param digest The buffer to store the DIGEST_SIZE bytes of the digest
     */
-    UInt32* pad(const std::string& str, UInt32& groupNum) {
-        UInt32 strLen = (UInt32)str.length();
-
-        // Each group has 64 bytes = 512 bits.
-        // Add 8 bytes = 64 bits to store original length.
-        groupNum = ((strLen + 8) >> 6) + 1;
-
-        // Each group stores as 16 32-bit intergers
-        UInt32 len = groupNum << 4;
-        UInt32 *res = new UInt32[len];
-        for (UInt32 i = 0; i < len; ++i) {
-            res[i] = 0;
+    void finalize(unsigned char *const digest) noexcept {
+        // Append one '1' bit, then '0' bits until 8 bytes are left
+        // in the block, then the message length in bits
+        unsigned char tail[BLOCK_SIZE + 8] = {0x80};
+        UInt64 bits = total << 3;
+        SizeType padLen = (used < 56 ? 56 : 120) - used;
+        for (int i = 0; i < 8; ++i) {
+            tail[padLen + i] = (unsigned char)(bits >> (i * 8));
         }
-
-        // One 32-bit integer stores 4 character(8 bytes)
-        for (UInt32 i = 0; i < strLen; ++i) {
-            res[i >> 2] |= str[i] << ((i % 4) << 3);
+        update(tail, padLen + 8);
+        for (int i = 0; i < 16; ++i) {
+            digest[i] = (unsigned char)(state[i >> 2] >> ((i & 3) << 3));
         }
-        res[strLen >> 2] |= (1 << 7) << ((strLen % 4) << 3);  // Append one '1' at the end 
+        reset();
+    }
+
+    /*
+    Finish the message and start a new one.
+
+    @return The hashed string result
+    */
+    std::string finalize() {
+        unsigned char digest[DIGEST_SIZE];
+        finalize(digest);
+        return toHex(digest);
+    }
 
-        // Append original length of the message in bits
-        UInt64 originLenInBits = (UInt64)strLen << 3;
-        res[len - 1] = originLenInBits >> 32;  // MSB
-        res[len - 2] = originLenInBits & 0xffffffff;  // LSB
+    /*
+    Encode a digest in lowercase hexadecimal.
+
+    @param digest The DIGEST_SIZE bytes of the digest
+    @param hex    The buffer to store the DIGEST_SIZE * 2 characters, not null-terminated
+    */
+    static void toHex(const unsigned char *const digest, char *const hex) noexcept {
+        jumble::toHex(digest, DIGEST_SIZE, hex);
+    }
+
+    /*
+    Encode a digest in lowercase hexadecimal.
+
+    @param digest The DIGEST_SIZE bytes of the digest
+    @return       The hexadecimal string
+    */
+    static std::string toHex(const unsigned char *const digest) {
+        std::string res(DIGEST_SIZE * 2, '0');
+        toHex(digest, &res[0]);
         return res;
     }
 
+private:
     /*
-    Loop 64 times for each group and calculate a, b, c and d.
+    Process complete blocks.
 
-    @param group   The group to be processed
-    @param a/b/c/d The four 32-bit integer of hashed text
+    @param p      The blocks
+    @param blocks The amount of blocks
     */
-    void loop(const UInt32 *const group, UInt32& a, UInt32& b, UInt32& c, UInt32& d) noexcept {
-        UInt32 f, g;
-        UInt32 A = a, B = b, C = c, D = d;
-        for (int i = 0; i < 64; ++i) {  // Loop for 4 turns, process 16 times in each turn
-            if (i < 16) {
-                f = (B & C) | ((~B) & D);
-                g = i;
-            } else if (i < 32) {
-                f = (D & B) | ((~D) & C);
-                g = (5 * i + 1) % 16;
-            } else if (i < 48) {
-                f = B ^ C ^ D;
-                g = (3 * i + 5) % 16;
-            } else {
-                f = C ^ (B | (~D));
-                g = (7 * i) % 16;
+    void process(const unsigned char *p, SizeType blocks) noexcept {
+        UInt32 st[4] = {state[0], state[1], state[2], state[3]};  // Kept in registers
+        for (; blocks; --blocks, p += BLOCK_SIZE) {
+            UInt32 x[16];  // Each block contains 16 little-endian 32-bit integers
+            for (int j = 0; j < 16; ++j) {
+                x[j] = (UInt32)p[j * 4] | (UInt32)p[j * 4 + 1] << 8
+                       | (UInt32)p[j * 4 + 2] << 16 | (UInt32)p[j * 4 + 3] << 24;
             }
-            UInt32 tmp = D;
-            D = C;
-            C = B;
-            B = B + cycleShiftLeft((A + f + k[i] + group[g]), s[i]);
-            A = tmp;
+            MD5Compression<MD5ScalarOps>::run(st, x);
+        }
+        for (int i = 0; i < 4; ++i) {
+            state[i] = st[i];
         }
-        a += A, b += B, c += C, d += D;
+    }
+
+private:
+    UInt32 state[4];  // a, b, c and d
+    UInt64 total;     // Length of the message in bytes
+    SizeType used;    // Bytes in the buffer
+    unsigned char buffer[BLOCK_SIZE];  // The partial block
+};
+
+/*
+MD5 of whole messages. All functions are static and keep no state, so
+they can be called from any amount of threads at the same time.
+*/
+class MD5 {
+public:
+    // Forbid copy
+    MD5(const MD5&) = delete;
+    MD5& operator=(const MD5&) = delete;
+
+    // Forbid move
+    MD5(MD5&&) = delete;
+    MD5& operator=(MD5&&) = delete;
+
+    // Return the singleton instance, kept for compatibility as all functions are static
+    static MD5* getInstance() {
+        static MD5 instance;
+        return &instance;
     }
 
     /*
-    Map a 32-bit integer to its hexadecimal presentation.
+    Hash a message.
 
-    @param num The 32-bit integer
-    @return    A string that stores the hexadecimal presentation
+    @param msg The message to be hashed
+    @return    The hashed string result
     */
-    std::string toHexStr(const UInt32 num) {
-        std::string tmp, res = "";
-        for (UInt32 i = 0; i < 4; ++i) {
-            tmp = "";
-            int byte = (num >> (i << 3)) % (1 << 8);
-            for (UInt32 j = 0; j < 2; ++j) {
-                tmp.insert(0, 1, hex[byte % 16]);
-                byte >>= 4;
-            }
-            res += tmp;
-        }
-        return res;
+    static std::string hash(const std::string& msg) {
+        return hash(msg.data(), msg.size());
     }
 
     /*
-    Cycle shift left.
+    Hash a message.
 
-    @param num      The number to be shifted
-    @param shiftCnt The shift count
-    @return         The number after shifted
+    @param data The message to be hashed
+    @param len  The length of the message in bytes
+    @return     The hashed string result
     */
-    UInt32 cycleShiftLeft(const UInt32 num, const UInt32 shiftCnt) noexcept {
-        return (num << shiftCnt) | (num >> (32 - shiftCnt));
+    static std::string hash(const void *const data, const MD5Context::SizeType len) {
+        unsigned char digest[MD5Context::DIGEST_SIZE];
+        hash(data, len, digest);
+        return MD5Context::toHex(digest);
     }
 
-private:
-    // Hexadecimal character
-    const std::string hex;
+    /*
+    Hash a message without allocating memory. See MD5Context::toHex()
+    for the hexadecimal form of the digest.
 
-    // Left shift number
-    const std::vector<UInt32> s;
+    @param data   The message to be hashed
+    @param len    The length of the message in bytes
+    @param digest The buffer to store the MD5Context::DIGEST_SIZE bytes of the digest
+    */
+    static void hash(const void *const data, const MD5Context::SizeType len, unsigned char *const digest) noexcept {
+        MD5Context ctx;
+        ctx.update(data, len);
+        ctx.finalize(digest);
+    }
 
-    // Constants in main loop
-    const std::vector<UInt32> k;
+private:
+    // Default ctor
+    MD5() = default;
 };
 
 JUMBLE_NAMESPACE_END
@@ -0,0 +1,265 @@
+#include "jumble/md5_multi_buffer.hpp"
+#include <stdexcept>
+#include <cstring>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+JUMBLE_NAMESPACE_BEGIN
+
+// Kernels compiled with their own instruction sets, nullptr if not compiled in
+MD5MultiBuffer::Compress md5MultiBufferAVX2() noexcept;
+MD5MultiBuffer::Compress md5MultiBufferAVX512() noexcept;
+
+namespace {
+
+using UInt32 = MD5MultiBuffer::UInt32;
+using SizeType = MD5MultiBuffer::SizeType;
+
+void compressScalar(UInt32 *const state, const UInt32 *const words) {
+    UInt32 st[4], x[16];
+    std::memcpy(st, state, sizeof(st));
+    std::memcpy(x, words, sizeof(x));
+    MD5Compression<MD5ScalarOps>::run(st, x);
+    std::memcpy(state, st, sizeof(st));
+}
+
+#ifdef __SSE2__
+// Operations on 4 words, see MD5Compression
+struct SSE2Ops {
+    using Word = __m128i;
+
+    static Word set(const UInt32 k) noexcept {
+        return _mm_set1_epi32((int)k);
+    }
+
+    static Word add(const Word a, const Word b) noexcept {
+        return _mm_add_epi32(a, b);
+    }
+
+    static Word bitAnd(const Word a, const Word b) noexcept {
+        return _mm_and_si128(a, b);
+    }
+
+    static Word bitXor(const Word a, const Word b) noexcept {
+        return _mm_xor_si128(a, b);
+    }
+
+    static Word andNot(const Word a, const Word b) noexcept {
+        return _mm_andnot_si128(a, b);
+    }
+
+    static Word orNot(const Word a, const Word b) noexcept {
+        return _mm_or_si128(a, _mm_xor_si128(b, _mm_set1_epi32(-1)));
+    }
+
+    template<int S>
+    static Word rotate(const Word a) noexcept {
+        return _mm_or_si128(_mm_slli_epi32(a, S), _mm_srli_epi32(a, 32 - S));
+    }
+};
+
+void compressSSE2(UInt32 *const state, const UInt32 *const words) {
+    __m128i st[4], x[16];
+    for (int i = 0; i < 4; ++i) {
+        st[i] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(state + i * 4));
+    }
+    for (int i = 0; i < 16; ++i) {
+        x[i] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(words + i * 4));
+    }
+    MD5Compression<SSE2Ops>::run(st, x);
+    for (int i = 0; i < 4; ++i) {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(state + i * 4), st[i]);
+    }
+}
+#endif
+
+// Return the kernel compiled in for a given type, or nullptr
+MD5MultiBuffer::Compress getCompress(const MD5MultiBuffer::Kernel k) noexcept {
+    switch (k) {
+        case MD5MultiBuffer::SCALAR:
+            return compressScalar;
+#ifdef __SSE2__
+        case MD5MultiBuffer::SSE2:
+            return compressSSE2;
+#endif
+        case MD5MultiBuffer::AVX2:
+            return md5MultiBufferAVX2();
+        case MD5MultiBuffer::AVX512:
+            return md5MultiBufferAVX512();
+        default:
+            return nullptr;
+    }
+}
+
+// Return true if the CPU supports the instruction set of a kernel
+bool isCPUSupported(const MD5MultiBuffer::Kernel k) noexcept {
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+    switch (k) {
+        case MD5MultiBuffer::SSE2:
+            return __builtin_cpu_supports("sse2");
+        case MD5MultiBuffer::AVX2:
+            return __builtin_cpu_supports("avx2");
+        case MD5MultiBuffer::AVX512:
+            return __builtin_cpu_supports("avx512f");
+        default:
+            return true;
+    }
+#else
+    return k == MD5MultiBuffer::SCALAR;
+#endif
+}
+
+// A message being hashed in a lane
+struct Lane {
+    SizeType msg;                  // Index of the message
+    const unsigned char *block;    // The next block of the message itself
+    SizeType blocks;               // Complete blocks left in the message
+    SizeType tailBlocks;           // Padded blocks in 'tail'
+    SizeType tailDone;             // Padded blocks processed
+    unsigned char tail[MD5Context::BLOCK_SIZE * 2];
+    bool active;
+
+    // Start hashing a message
+    void assign(const SizeType i, const void *const data, const SizeType len) noexcept {
+        msg = i;
+        block = static_cast<const unsigned char*>(data);
+        blocks = len / MD5Context::BLOCK_SIZE;
+        // The remaining bytes, one '1' bit, '0' bits and the length in bits
+        SizeType rest = len % MD5Context::BLOCK_SIZE;
+        tailBlocks = rest < 56 ? 1 : 2;
+        tailDone = 0;
+        std::memset(tail, 0, sizeof(tail));
+        if (rest) {
+            std::memcpy(tail, block + blocks * MD5Context::BLOCK_SIZE, rest);
+        }
+        tail[rest] = 0x80;
+        std::uint64_t bits = (std::uint64_t)len << 3;
+        unsigned char *end = tail + tailBlocks * MD5Context::BLOCK_SIZE;
+        for (int j = 0; j < 8; ++j) {
+            end[j - 8] = (unsigned char)(bits >> (j * 8));
+        }
+        active = true;
+    }
+
+    // Return the next block and move past it
+    const unsigned char* next() noexcept {
+        if (blocks) {
+            --blocks;
+            const unsigned char *res = block;
+            block += MD5Context::BLOCK_SIZE;
+            return res;
+        }
+        return tail + tailDone++ * MD5Context::BLOCK_SIZE;
+    }
+
+    bool isDone() const noexcept {
+        return blocks == 0 && tailDone == tailBlocks;
+    }
+};
+
+}  // namespace
+
+bool MD5MultiBuffer::isSupported(const Kernel k) noexcept {
+    return getCompress(k) != nullptr && isCPUSupported(k);
+}
+
+MD5MultiBuffer::Kernel MD5MultiBuffer::getBestKernel() noexcept {
+    for (Kernel k : {AVX512, AVX2, SSE2}) {
+        if (isSupported(k)) {
+            return k;
+        }
+    }
+    return SCALAR;
+}
+
+MD5MultiBuffer::SizeType MD5MultiBuffer::getLaneCount(const Kernel k) noexcept {
+    switch (k) {
+        case SSE2:
+            return 4;
+        case AVX2:
+            return 8;
+        case AVX512:
+            return 16;
+        default:
+            return 1;
+    }
+}
+
+MD5MultiBuffer::MD5MultiBuffer(const Kernel kernel_)
+    : kernel(kernel_), compress(getCompress(kernel_)) {
+    if (!isSupported(kernel_)) {
+        throw std::invalid_argument("MD5 kernel not supported");
+    }
+}
+
+void MD5MultiBuffer::hash(const void *const *data, const SizeType *lens, const SizeType n,
+                          unsigned char *digests) const {
+    static const unsigned char ZEROS[MD5Context::BLOCK_SIZE] = {0};
+    const SizeType lanes = getLaneCount(kernel);
+    alignas(64) UInt32 state[4 * MAX_LANES];
+    alignas(64) UInt32 words[16 * MAX_LANES];
+    Lane lane[MAX_LANES];
+    for (SizeType j = 0; j < lanes; ++j) {
+        lane[j].active = false;
+    }
+
+    SizeType nextMsg = 0, active = 0;
+    while (true) {
+        // Give the next messages to idle lanes
+        for (SizeType j = 0; j < lanes && nextMsg < n; ++j) {
+            if (!lane[j].active) {
+                lane[j].assign(nextMsg, data[nextMsg], lens[nextMsg]);
+                ++nextMsg;
+                ++active;
+                state[j] = 0x67452301;
+                state[lanes + j] = 0xefcdab89;
+                state[lanes * 2 + j] = 0x98badcfe;
+                state[lanes * 3 + j] = 0x10325476;
+            }
+        }
+        if (!active) {
+            break;
+        }
+
+        // Transpose the blocks so each word of all lanes is contiguous
+        for (SizeType j = 0; j < lanes; ++j) {
+            const unsigned char *p = lane[j].active ? lane[j].next() : ZEROS;
+            for (SizeType i = 0; i < 16; ++i, p += 4) {
+                words[i * lanes + j] = (UInt32)p[0] | (UInt32)p[1] << 8
+                                       | (UInt32)p[2] << 16 | (UInt32)p[3] << 24;
+            }
+        }
+        compress(state, words);
+
+        for (SizeType j = 0; j < lanes; ++j) {
+            if (lane[j].active && lane[j].isDone()) {
+                unsigned char *digest = digests + lane[j].msg * DIGEST_SIZE;
+                for (SizeType i = 0; i < DIGEST_SIZE; ++i) {
+                    digest[i] = (unsigned char)(state[(i >> 2) * lanes + j] >> ((i & 3) << 3));
+                }
+                lane[j].active = false;
+                --active;
+            }
+        }
+    }
+}
+
+std::vector<std::string> MD5MultiBuffer::hash(const std::vector<std::string>& msgs) const {
+    std::vector<const void*> data(msgs.size());
+    std::vector<SizeType> lens(msgs.size());
+    for (SizeType i = 0; i < msgs.size(); ++i) {
+        data[i] = msgs[i].data();
+        lens[i] = msgs[i].size();
+    }
+    std::vector<unsigned char> digests(msgs.size() * DIGEST_SIZE);
+    hash(data.data(), lens.data(), msgs.size(), digests.data());
+
+    std::vector<std::string> res(msgs.size(), std::string(DIGEST_SIZE * 2, '0'));
+    for (SizeType i = 0; i < msgs.size(); ++i) {
+        MD5Context::toHex(&digests[i * DIGEST_SIZE], &res[i][0]);
+    }
+    return res;
+}
+
+JUMBLE_NAMESPACE_END
@@ -0,0 +1,90 @@
+#ifndef JUMBLE_MD5_MULTI_BUFFER_HPP_INCLUDED
+#define JUMBLE_MD5_MULTI_BUFFER_HPP_INCLUDED
+
+#include "jumble/md5.hpp"
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+JUMBLE_NAMESPACE_BEGIN
+
+/*
+MD5 of many independent messages at once. Each message is hashed in one
+lane of a SIMD register: 4 lanes with SSE2, 8 with AVX2 and 16 with
+AVX-512. A lane takes the next message as soon as its message is done,
+so messages of different lengths keep all lanes busy.
+
+The kernels are compiled for their instruction sets regardless of the
+compiler flags of the library and chosen by the CPU at runtime. They
+run the same unrolled steps as MD5Context, see MD5Compression.
+*/
+class MD5MultiBuffer {
+public:
+    using SizeType = std::size_t;
+    using UInt32 = std::uint32_t;
+
+    static const SizeType DIGEST_SIZE = MD5Context::DIGEST_SIZE;
+    static const SizeType MAX_LANES = 16;
+
+    enum Kernel {
+        SCALAR,  // One lane, any CPU
+        SSE2,    // 4 lanes
+        AVX2,    // 8 lanes
+        AVX512   // 16 lanes
+    };
+
+    /*
+    Process one block of each lane. state[i * #lanes + j] is word 'i'
+    of the digest of lane 'j', and words[i * #lanes + j] is word 'i' of
+    the block of lane 'j'.
+    */
+    using Compress = void (*)(UInt32 *state, const UInt32 *words);
+
+    // Return true if a kernel is compiled in and supported by the CPU
+    static bool isSupported(Kernel k) noexcept;
+
+    // Return the supported kernel with the most lanes
+    static Kernel getBestKernel() noexcept;
+
+    // Return the amount of lanes of a kernel
+    static SizeType getLaneCount(Kernel k) noexcept;
+
+    /*
+    Initialize the hasher.
+
+    @param kernel_ The kernel, the best supported one by default
+    @throw std::invalid_argument if the kernel is not supported
+    */
+    explicit MD5MultiBuffer(Kernel kernel_ = getBestKernel());
+
+    Kernel getKernel() const noexcept {
+        return kernel;
+    }
+
+    /*
+    Hash messages. The function is reentrant.
+
+    @param data    The addresses of the messages
+    @param lens    The lengths of the messages in bytes
+    @param n       The amount of messages
+    @param digests The buffer to store the digests, n * DIGEST_SIZE bytes
+    */
+    void hash(const void *const *data, const SizeType *lens, SizeType n, unsigned char *digests) const;
+
+    /*
+    Hash messages.
+
+    @param msgs The messages
+    @return     The hashed string results, see MD5::hash()
+    */
+    std::vector<std::string> hash(const std::vector<std::string>& msgs) const;
+
+private:
+    Kernel kernel;
+    Compress compress;
+};
+
+JUMBLE_NAMESPACE_END
+
+#endif
@@ -0,0 +1,79 @@
+// Compiled with AVX2 enabled. Nothing here may be shared with other
+// translation units, or the linker could pick AVX2 code for them.
+
+#include "jumble/md5_multi_buffer.hpp"
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+JUMBLE_NAMESPACE_BEGIN
+
+#ifdef __AVX2__
+
+namespace {
+
+using UInt32 = MD5MultiBuffer::UInt32;
+
+// Operations on 8 words, see MD5Compression
+struct AVX2Ops {
+    using Word = __m256i;
+
+    static Word set(const UInt32 k) noexcept {
+        return _mm256_set1_epi32((int)k);
+    }
+
+    static Word add(const Word a, const Word b) noexcept {
+        return _mm256_add_epi32(a, b);
+    }
+
+    static Word bitAnd(const Word a, const Word b) noexcept {
+        return _mm256_and_si256(a, b);
+    }
+
+    static Word bitXor(const Word a, const Word b) noexcept {
+        return _mm256_xor_si256(a, b);
+    }
+
+    static Word andNot(const Word a, const Word b) noexcept {
+        return _mm256_andnot_si256(a, b);
+    }
+
+    static Word orNot(const Word a, const Word b) noexcept {
+        return _mm256_or_si256(a, _mm256_xor_si256(b, _mm256_set1_epi32(-1)));
+    }
+
+    template<int S>
+    static Word rotate(const Word a) noexcept {
+        return _mm256_or_si256(_mm256_slli_epi32(a, S), _mm256_srli_epi32(a, 32 - S));
+    }
+};
+
+void compressAVX2(UInt32 *const state, const UInt32 *const words) {
+    __m256i st[4], x[16];
+    for (int i = 0; i < 4; ++i) {
+        st[i] = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(state + i * 8));
+    }
+    for (int i = 0; i < 16; ++i) {
+        x[i] = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(words + i * 8));
+    }
+    MD5Compression<AVX2Ops>::run(st, x);
+    for (int i = 0; i < 4; ++i) {
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(state + i * 8), st[i]);
+    }
+}
+
+}  // namespace
+
+MD5MultiBuffer::Compress md5MultiBufferAVX2() noexcept {
+    return compressAVX2;
+}
+
+#else
+
+MD5MultiBuffer::Compress md5MultiBufferAVX2() noexcept {
+    return nullptr;
+}
+
+#endif
+
+JUMBLE_NAMESPACE_END
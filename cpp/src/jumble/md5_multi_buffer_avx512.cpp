@@ -0,0 +1,83 @@
+// Compiled with AVX-512 enabled. Nothing here may be shared with other
+// translation units, or the linker could pick AVX-512 code for them.
+
+#include "jumble/md5_multi_buffer.hpp"
+#ifdef __AVX512F__
+#include <immintrin.h>
+#endif
+
+JUMBLE_NAMESPACE_BEGIN
+
+#ifdef __AVX512F__
+
+namespace {
+
+using UInt32 = MD5MultiBuffer::UInt32;
+
+// Operations on 16 words, see MD5Compression
+struct AVX512Ops {
+    using Word = __m512i;
+
+    static Word set(const UInt32 k) noexcept {
+        return _mm512_set1_epi32((int)k);
+    }
+
+    static Word add(const Word a, const Word b) noexcept {
+        return _mm512_add_epi32(a, b);
+    }
+
+    static Word bitAnd(const Word a, const Word b) noexcept {
+        return _mm512_and_si512(a, b);
+    }
+
+    static Word bitXor(const Word a, const Word b) noexcept {
+        return _mm512_xor_si512(a, b);
+    }
+
+    // Ternary logic takes the truth table of the three inputs (a, b, b).
+    // GCC warns about the undefined source of _mm512_andnot_si512.
+    static Word andNot(const Word a, const Word b) noexcept {
+        return _mm512_ternarylogic_epi32(a, b, b, 0x0c);
+    }
+
+    // a | ~b in one instruction
+    static Word orNot(const Word a, const Word b) noexcept {
+        return _mm512_ternarylogic_epi32(a, b, b, 0xf3);
+    }
+
+    // The masked form, as GCC warns about the undefined source of the unmasked one
+    template<int S>
+    static Word rotate(const Word a) noexcept {
+        return _mm512_mask_rol_epi32(a, (__mmask16)0xffff, a, S);
+    }
+};
+
+void compressAVX512(UInt32 *const state, const UInt32 *const words) {
+    __m512i st[4], x[16];
+    for (int i = 0; i < 4; ++i) {
+        st[i] = _mm512_loadu_si512(state + i * 16);
+    }
+    for (int i = 0; i < 16; ++i) {
+        x[i] = _mm512_loadu_si512(words + i * 16);
+    }
+    MD5Compression<AVX512Ops>::run(st, x);
+    for (int i = 0; i < 4; ++i) {
+        _mm512_storeu_si512(state + i * 16, st[i]);
+    }
+}
+
+}  // namespace
+
+MD5MultiBuffer::Compress md5MultiBufferAVX512() noexcept {
+    return compressAVX512;
+}
+
+#else
+
+MD5MultiBuffer::Compress md5MultiBufferAVX512() noexcept {
+    return nullptr;
+}
+
+#endif
+
+JUMBLE_NAMESPACE_END
@@ -0,0 +1,253 @@
+#ifndef JUMBLE_MERKLE_TREE_HPP_INCLUDED
+#define JUMBLE_MERKLE_TREE_HPP_INCLUDED
+
+#include "jumble/md5.hpp"
+#include "jumble/util/thread_pool.hpp"
+#include "jumble/util/mapped_file.hpp"
+#include "jumble/util/hex.hpp"
+#include <vector>
+#include <string>
+#include <stdexcept>
+#include <algorithm>
+#include <cstring>
+#include <cstddef>
+
+JUMBLE_NAMESPACE_BEGIN
+
+/*
+A tree-hashed digest of a large message. The message is split into
+chunks of a fixed size, the chunks are hashed in parallel, and each
+level of the tree hashes pairs of digests of the level below up to one
+root digest. A node without a sibling moves up unchanged.
+
+Leaves hash the byte 0 followed by the chunk, and inner nodes hash the
+byte 1 followed by both children, so a leaf never equals an inner node.
+The root therefore differs from the plain digest of the message.
+
+Once built, the tree tells which chunks of a new version of the message
+differ, and update() rehashes only the given chunks and their ancestors.
+
+@param Context The digest, with the interface of MD5Context: default ctor,
+               update(data, len), finalize(digest) and DIGEST_SIZE
+*/
+template<typename Context = MD5Context>
+class MerkleTree {
+public:
+    using SizeType = std::size_t;
+
+    static const SizeType DIGEST_SIZE = Context::DIGEST_SIZE;
+
+    /*
+    Initialize an empty tree.
+
+    @param pool_      The threads to hash the chunks
+    @param chunkSize_ The size of a chunk in bytes
+    @throw std::invalid_argument if the chunk size is zero
+    */
+    explicit MerkleTree(ThreadPool& pool_, const SizeType chunkSize_ = 1 << 20)
+        : pool(pool_), chunkSize(chunkSize_), length(0) {
+        if (chunkSize == 0) {
+            throw std::invalid_argument("chunk size must be positive");
+        }
+    }
+
+    SizeType getChunkSize() const noexcept {
+        return chunkSize;
+    }
+
+    // Return the length of the message in bytes
+    SizeType getLength() const noexcept {
+        return length;
+    }
+
+    // Return the amount of chunks, an empty message has one empty chunk
+    SizeType getChunkCount() const noexcept {
+        return levels.empty() ? 0 : levels[0].size() / DIGEST_SIZE;
+    }
+
+    // Return the DIGEST_SIZE bytes of the digest of a chunk
+    const unsigned char* getChunkDigest(const SizeType i) const noexcept {
+        return &levels[0][i * DIGEST_SIZE];
+    }
+
+    /*
+    Return the DIGEST_SIZE bytes of the root digest.
+    Precondition: the tree is built
+    */
+    const unsigned char* getRoot() const noexcept {
+        return levels.back().data();
+    }
+
+    /*
+    Return the root digest in hexadecimal.
+    Precondition: the tree is built
+    */
+    std::string getRootHex() const {
+        std::string res(DIGEST_SIZE * 2, '0');
+        toHex(getRoot(), DIGEST_SIZE, &res[0]);
+        return res;
+    }
+
+    /*
+    Build the tree of a message.
+
+    @param data The message
+    @param len  The length of the message in bytes
+    */
+    void build(const void *const data, const SizeType len) {
+        length = len;
+        SizeType n = std::max((len + chunkSize - 1) / chunkSize, (SizeType)1);
+        levels.assign(1, std::vector<unsigned char>(n * DIGEST_SIZE));
+        const unsigned char *p = static_cast<const unsigned char*>(data);
+        pool.parallelFor(0, n, [this, p](const SizeType beg, const SizeType end) {
+            for (SizeType i = beg; i < end; ++i) {
+                hashChunk(p, i, &levels[0][i * DIGEST_SIZE]);
+            }
+        });
+        for (; n > 1; n = (n + 1) / 2) {
+            levels.emplace_back((n + 1) / 2 * DIGEST_SIZE);
+            for (SizeType i = 0; i < n; i += 2) {
+                hashNode(levels.size() - 1, i / 2);
+            }
+        }
+    }
+
+    /*
+    Build the tree of a file.
+
+    @param path The path of the file
+    @throw std::runtime_error if the file cannot be read
+    */
+    void buildFile(const std::string& path) {
+        MappedFile file(path);
+        build(file.data(), file.getSize());
+    }
+
+    /*
+    Find the chunks of a message that differ from the tree. All chunks
+    are hashed in parallel, but the tree is left unchanged.
+    Precondition: the tree is built
+
+    @param data The message
+    @param len  The length of the message in bytes
+    @return     The indices of the differing chunks in ascending order
+    @throw std::invalid_argument if the length differs from the tree
+    */
+    std::vector<SizeType> verify(const void *const data, const SizeType len) const {
+        checkLength(len);
+        const SizeType n = getChunkCount();
+        const unsigned char *p = static_cast<const unsigned char*>(data);
+        std::vector<char> changed(n, 0);
+        pool.parallelFor(0, n, [this, p, &changed](const SizeType beg, const SizeType end) {
+            unsigned char digest[DIGEST_SIZE];
+            for (SizeType i = beg; i < end; ++i) {
+                hashChunk(p, i, digest);
+                changed[i] = std::memcmp(digest, getChunkDigest(i), DIGEST_SIZE) != 0;
+            }
+        });
+        std::vector<SizeType> res;
+        for (SizeType i = 0; i < n; ++i) {
+            if (changed[i]) {
+                res.push_back(i);
+            }
+        }
+        return res;
+    }
+
+    /*
+    Find the chunks of a file that differ from the tree.
+
+    @param path The path of the file
+    @return     The indices of the differing chunks in ascending order
+    @throw std::runtime_error if the file cannot be read
+    @throw std::invalid_argument if the length differs from the tree
+    */
+    std::vector<SizeType> verifyFile(const std::string& path) const {
+        MappedFile file(path);
+        return verify(file.data(), file.getSize());
+    }
+
+    /*
+    Rehash some chunks of a new version of the message, and the nodes
+    on their paths to the root. Other chunks are assumed unchanged, e.g.
+    the chunks found by verify() or written since the tree was built.
+    Precondition: the tree is built
+
+    @param data   The new message
+    @param len    The length of the message in bytes
+    @param chunks The indices of the changed chunks
+    @throw std::invalid_argument if the length differs from the tree,
+                                 or a chunk is out of range
+    */
+    void update(const void *const data, const SizeType len, std::vector<SizeType> chunks) {
+        checkLength(len);
+        for (SizeType i : chunks) {
+            if (i >= getChunkCount()) {
+                throw std::invalid_argument("chunk index out of range");
+            }
+        }
+        std::sort(chunks.begin(), chunks.end());
+        chunks.erase(std::unique(chunks.begin(), chunks.end()), chunks.end());
+        const unsigned char *p = static_cast<const unsigned char*>(data);
+        pool.parallelFor(0, chunks.size(), [this, p, &chunks](const SizeType beg, const SizeType end) {
+            for (SizeType i = beg; i < end; ++i) {
+                hashChunk(p, chunks[i], &levels[0][chunks[i] * DIGEST_SIZE]);
+            }
+        });
+        // The parents of sorted nodes are sorted, so duplicates are adjacent
+        for (SizeType level = 1; level < levels.size(); ++level) {
+            SizeType m = 0;
+            for (SizeType i : chunks) {
+                if (m == 0 || chunks[m - 1] != i / 2) {
+                    chunks[m++] = i / 2;
+                }
+            }
+            chunks.resize(m);
+            for (SizeType i : chunks) {
+                hashNode(level, i);
+            }
+        }
+    }
+
+private:
+    void checkLength(const SizeType len) const {
+        if (len != length) {
+            throw std::invalid_argument("message length differs from the tree");
+        }
+    }
+
+    // Hash chunk 'i' of a message as a leaf
+    void hashChunk(const unsigned char *const p, const SizeType i, unsigned char *const digest) const {
+        static const unsigned char LEAF = 0;
+        SizeType beg = i * chunkSize;
+        Context ctx;
+        ctx.update(&LEAF, 1);
+        ctx.update(p + beg, std::min(chunkSize, length - beg));
+        ctx.finalize(digest);
+    }
+
+    // Recompute node 'i' of a level from its children
+    void hashNode(const SizeType level, const SizeType i) {
+        static const unsigned char INNER = 1;
+        const std::vector<unsigned char> &below = levels[level - 1];
+        unsigned char *digest = &levels[level][i * DIGEST_SIZE];
+        if ((i * 2 + 2) * DIGEST_SIZE > below.size()) {
+            std::memcpy(digest, &below[i * 2 * DIGEST_SIZE], DIGEST_SIZE);
+            return;
+        }
+        Context ctx;
+        ctx.update(&INNER, 1);
+        ctx.update(&below[i * 2 * DIGEST_SIZE], DIGEST_SIZE * 2);
+        ctx.finalize(digest);
+    }
+
+private:
+    ThreadPool &pool;
+    SizeType chunkSize;
+    SizeType length;
+    std::vector<std::vector<unsigned char>> levels;  // Digests of each level, the leaves first
+};
+
+JUMBLE_NAMESPACE_END
+
+#endif
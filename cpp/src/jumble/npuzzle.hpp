@@ -1,14 +1,25 @@
 #ifndef JUMBLE_NPUZZLE_HPP_INCLUDED
 #define JUMBLE_NPUZZLE_HPP_INCLUDED
 
-#include "jumble/hash_table.hpp"
+#include "jumble/astar.hpp"
 #include "jumble/binary_heap.hpp"
 #include "jumble/util/random.hpp"
+#include "jumble/util/arena.hpp"
 #include <vector>
 #include <sstream>
 #include <string>
 #include <list>
+#include <functional>
 #include <utility>
+#include <unordered_map>
+#include <memory>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+#include <cstdint>
 
 JUMBLE_NAMESPACE_BEGIN
 
@@ -22,6 +33,16 @@ enum Direc {
 
 class NPuzzle;
 
+/*
+A configuration of the puzzle with at most MAX_GRIDS grids. The whole
+board is packed into one 128-bit integer with BITS bits per grid, so
+a node fits in a few cache words, moves are shifts and masks, and
+comparing two boards is a single integer comparison.
+
+The node also keeps a Zobrist hash of its board, which each move
+updates in O(1) by XOR-ing out the old and in the new key of the
+moved number.
+*/
 class PuzzleNode {
     friend class NPuzzle;
 
@@ -29,6 +50,9 @@ public:
     using Container = std::vector<int>;
     using SizeType = Container::size_type;
 
+    static const SizeType BITS = 5;  // Bits to store one grid number
+    static const SizeType MAX_GRIDS = 25;  // Up to 5*5
+
     /*
     Initialize the node. The node value is stored in an one-dimension array.
     For a 3*3 puzzle, the contents of the array must be like this:
@@ -39,12 +63,29 @@ public:
     @param val_ The node value
     @param row_ The row amount
     @param col_ The column amount
+    @throw std::invalid_argument if the node value doesn't match the
+           size or is not a permutation of 0 to row * col - 1,
+           or the puzzle has more than MAX_GRIDS grids
     */
     PuzzleNode(const Container& val_, const SizeType row_, const SizeType col_)
-        : val(val_), row(row_), col(col_) {
-        for (SizeType i = 0; i < val.size(); ++i) {
-            if (val[i] == 0) {
-                emptyPos = i;
+        : row((std::uint8_t)row_), col((std::uint8_t)col_) {
+        if (row_ * col_ > MAX_GRIDS || val_.size() != row_ * col_) {
+            throw std::invalid_argument("invalid puzzle size");
+        }
+        std::uint32_t seen = 0;  // Bit 'k' is set if number 'k' is used
+        for (SizeType i = 0; i < val_.size(); ++i) {
+            if (val_[i] < 0 || (SizeType)val_[i] >= val_.size()) {
+                throw std::invalid_argument("invalid grid number " + std::to_string(val_[i]));
+            }
+            if (seen & ((std::uint32_t)1 << val_[i])) {
+                throw std::invalid_argument("duplicate grid number " + std::to_string(val_[i]));
+            }
+            seen |= (std::uint32_t)1 << val_[i];
+            val |= (Board)val_[i] << (i * BITS);
+            if (val_[i] == 0) {
+                emptyPos = (std::uint8_t)i;
+            } else {
+                key ^= zobrist(i, (SizeType)val_[i]);
             }
         }
     }
@@ -59,6 +100,16 @@ public:
         return col;
     }
 
+    // Return the amount of grids
+    SizeType getGridCount() const noexcept {
+        return (SizeType)row * col;
+    }
+
+    // Return the number at a given index of the one-dimension array
+    SizeType getNum(const SizeType i) const noexcept {
+        return (SizeType)((val >> (i * BITS)) & MASK);
+    }
+
     // Return true if the empty grid can move one step along a given direction
     bool canMove(const Direc d) const noexcept {
         switch (d) {
@@ -67,9 +118,9 @@ public:
             case UP:
                 return getRow(emptyPos) != 0;
             case RIGHT:
-                return getCol(emptyPos) != col - 1;
+                return getCol(emptyPos) != (SizeType)col - 1;
             case DOWN:
-                return getRow(emptyPos) != row - 1;
+                return getRow(emptyPos) != (SizeType)row - 1;
             case NONE:
                 return true;
             default:
@@ -78,7 +129,7 @@ public:
     }
 
     // Move the empty grid along a given direction
-    void move(const Direc d) {
+    void move(const Direc d) noexcept {
         SizeType goalPos = emptyPos;
         switch (d) {
             case LEFT:
@@ -97,8 +148,12 @@ public:
                 break;
         }
         if (emptyPos != goalPos) {
-            std::swap(val[emptyPos], val[goalPos]);
-            emptyPos = goalPos;
+            // The empty grid holds zero, so only the moved number is rewritten
+            Board num = (val >> (goalPos * BITS)) & MASK;
+            val &= ~(MASK << (goalPos * BITS));
+            val |= num << (emptyPos * BITS);
+            key ^= zobrist(goalPos, (SizeType)num) ^ zobrist(emptyPos, (SizeType)num);
+            emptyPos = (std::uint8_t)goalPos;
         }
     }
 
@@ -119,9 +174,9 @@ public:
     std::string toString() const {
         std::ostringstream oss;
         oss << "{";
-        for (SizeType i = 0; i < val.size(); ++i) {
+        for (SizeType i = 0; i < getGridCount(); ++i) {
             if (i) oss << ", ";
-            oss << val[i];
+            oss << getNum(i);
         }
         oss << "}";
         return oss.str();
@@ -148,8 +203,13 @@ public:
         return NONE;
     }
 
+    // Return the Zobrist hash of the node value
+    std::uint64_t hash() const noexcept {
+        return key;
+    }
+
     bool operator==(const PuzzleNode& n) const noexcept {
-        return getVal() == n.getVal();
+        return val == n.val;
     }
 
     bool operator<(const PuzzleNode& n) const noexcept {
@@ -157,14 +217,27 @@ public:
     }
 
 private:
-    // Return the node value
-    const Container& getVal() const noexcept {
-        return val;
-    }
+    __extension__ typedef unsigned __int128 Board;
 
-    // Return the hash value of the node
-    SizeType hash() const {
-        return std::hash<std::string>()(toString());
+    /*
+    Return the Zobrist key of a number at a given index. The keys are
+    generated once with SplitMix64 from a fixed seed, so hash values
+    are the same in every run. The empty grid has no key since its
+    position is decided by the other numbers.
+    */
+    static std::uint64_t zobrist(const SizeType i, const SizeType num) noexcept {
+        static const std::vector<std::uint64_t> keys = []() {
+            std::vector<std::uint64_t> res(MAX_GRIDS * MAX_GRIDS);
+            std::uint64_t seed = 0x6a09e667f3bcc908ULL;
+            for (auto &k : res) {
+                std::uint64_t z = (seed += 0x9e3779b97f4a7c15ULL);
+                z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+                z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+                k = z ^ (z >> 31);
+            }
+            return res;
+        }();
+        return keys[i * MAX_GRIDS + num];
     }
 
     /*
@@ -188,58 +261,45 @@ private:
     }
 
     /*
-    Return the adjacent node at a given direction.
+    Move the empty grid along a given direction and update the
+    heuristic value with the distance of the moved number.
     Precondition: the current node can move along the given direction
 
-    @param d The given direction
+    @param d    The given direction
+    @param dist The distance table, see heuristic()
     */
-    PuzzleNode* getNeighbor(const Direc d) const {
-        PuzzleNode* n = new PuzzleNode(*this);
-        n->move(d);
-        return n;
+    void move(const Direc d, const std::vector<std::uint8_t>& dist) noexcept {
+        SizeType from = emptyPos;
+        move(d);
+        // The moved number goes from the new empty grid to the old one
+        const std::uint8_t *line = &dist[getNum(from) * getGridCount()];
+        h = h - line[emptyPos] + line[from];
     }
 
     /*
-    Return the heuristic value to the destination node.
+    Return the heuristic value to the destination node, which is the
+    sum of the Manhattan distances of the numbers.
 
-    @param des   The destination node
-    @param index The index of each number in the destination node value array
+    @param dist The distance table. dist[num * #grids + i] is the
+                distance from index 'i' to the destination of 'num'.
     */
-    SizeType heuristic(const PuzzleNode *const des, const std::vector<SizeType>& index) const {
-        SizeType size = val.size();
-
-        // Number of nodes which are in a wrong position
-        SizeType wrong = 0;
-        for (SizeType i = 0; i < size; ++i) {
-            if (val[i] != des->val[i]) {
-                ++wrong;
-            }
-        }
-
-        // Distance to the destination
-        SizeType manhatten = 0, geometric = 0;
+    SizeType heuristic(const std::vector<std::uint8_t>& dist) const noexcept {
+        SizeType size = getGridCount(), res = 0;
         for (SizeType i = 0; i < size; ++i) {
-            if (val[i]) {  // Escape value 0
-                SizeType curR = getRow(i);
-                SizeType curC = getCol(i);
-                SizeType desR = getRow(index[val[i]]);
-                SizeType desC = getCol(index[val[i]]);
-                SizeType dR = curR > desR ? curR - desR : desR - curR;
-                SizeType dC = curC > desC ? curC - desC : desC - curC;
-                manhatten += dR + dC;
-                geometric += (SizeType)(sqrt(dR * dR + dC * dC));
+            SizeType num = getNum(i);
+            if (num) {  // Escape value 0
+                res += dist[num * size + i];
             }
         }
-
-        return 5 * (1 * wrong + 2 * manhatten + 1 * geometric);
+        return res;
     }
 
     void setG(const SizeType g_) noexcept {
-        g = g_;
+        g = (std::uint32_t)g_;
     }
 
     void setH(const SizeType h_) noexcept {
-        h = h_;
+        h = (std::uint32_t)h_;
     }
 
     void setParent(PuzzleNode* p) noexcept {
@@ -264,16 +324,18 @@ private:
 
 private:
     static const SizeType SHUFFLE_TIMES = 1000;
+    static constexpr Board MASK = (1 << BITS) - 1;
 
-    Container val;
+    Board val = 0;  // Grid i is stored at bits [i * BITS, (i + 1) * BITS)
+    std::uint64_t key = 0;  // Zobrist hash
+    PuzzleNode *parent = nullptr;
 
-    SizeType emptyPos = 0;
-    SizeType row = 0;
-    SizeType col = 0;
+    std::uint32_t g = 0;
+    std::uint32_t h = 0;
 
-    SizeType g = 0;
-    SizeType h = 0;
-    PuzzleNode *parent = nullptr;
+    std::uint8_t emptyPos = 0;
+    std::uint8_t row = 0;
+    std::uint8_t col = 0;
 };
 
 
@@ -282,48 +344,148 @@ public:
     using Node = PuzzleNode;
     using SizeType = Node::SizeType;
 
+    /*
+    A function returning the estimated distance from a node to the ending
+    node. It must never overestimate (i.e. be admissible) for solve()
+    to find shortest paths. See PatternDatabase.
+    */
+    using Heuristic = std::function<SizeType(const Node&)>;
+
+    /*
+    Statistics of the last search, see AStarStats. solve() fills all the
+    counters, while solveIDAStar() and solveHDAStar() only fill some.
+    */
+    using Stats = AStarStats;
+
+    // A function called with the statistics during solve()
+    using Progress = std::function<void(const Stats&)>;
+
+    // Data structures of the open list of solve()
+    enum OpenListType {
+        HEAP,   // Binary heap ordered by f
+        BUCKET  // Buckets indexed by f and then h, see BucketQueue
+    };
+
     NPuzzle(const Node& beg_, const Node& end_)
-        : beg(beg_), end(end_), closeList(1000000) {}
+        : beg(beg_), end(end_) {}
 
+    /*
+    Solve the puzzle with A* search, see AStar. The path is empty if the
+    ending node is not reachable, which is detected before searching.
+    */
     void solve() {
-        std::vector<SizeType> index = buildIndex();
         searchCnt = 0;
-        openList.push(&beg);
-        while (!openList.isEmpty()) {
-            Node *cur = nullptr;
-            do {
-                // Loop until the open list is empty or a node
-                // that is not in the close list is found.
-                cur = openList.top();
-                openList.pop();
-            } while (!openList.isEmpty() && closeList.has(cur));
-            if (openList.isEmpty() && closeList.has(cur)) {
-                // If all the nodes in the open list is in the
-                // close list, then there is no available path
-                // between the two nodes.
-                return;
-            }
-            ++searchCnt;
-            closeList.insert(cur);
-            if (*cur == end) {
-                buildPath(cur);
-                freeResources();
-                return;
+        stats = Stats();
+        path.clear();
+        if (!isReachable()) {
+            return;
+        }
+        std::vector<std::uint8_t> dist = buildDistance();
+        beg.setH(heuristic ? heuristic(beg) : beg.heuristic(dist));
+        if (openListType == BUCKET) {
+            searchAStar(bucketSearch, dist);
+        } else {
+            searchAStar(heapSearch, dist);
+        }
+    }
+
+    /*
+    Solve the puzzle with iterative deepening A* (IDA*), which runs
+    depth-first searches bounded by increasing f values. Only one node
+    is kept and moved back and forth, so it needs O(depth) memory and
+    solves instances whose A* search does not fit in memory. Moves
+    undoing the previous move are skipped.
+    Reference: Korf, Depth-First Iterative-Deepening: An Optimal
+    Admissible Tree Search, 1985.
+
+    The path is empty if the ending node is not reachable, which is
+    detected before searching.
+    */
+    void solveIDAStar() {
+        searchCnt = 0;
+        stats = Stats();
+        path.clear();
+        if (!isReachable()) {
+            return;
+        }
+        auto start = std::chrono::steady_clock::now();
+        std::vector<std::uint8_t> dist = buildDistance();
+        Node cur = beg;
+        cur.setH(heuristic ? heuristic(cur) : cur.heuristic(dist));
+        std::vector<Direc> stack;
+        SizeType bound = cur.getH();
+        while (true) {
+            SizeType next = searchIDAStar(cur, 0, bound, Direc::NONE, dist, stack);
+            if (next == FOUND) {
+                path.assign(stack.begin(), stack.end());
+                break;
             }
-            for (int i = 1; i < 5; ++i) {
-                Direc d = Direc(i);
-                if (cur->canMove(d)) {
-                    Node *adj = cur->getNeighbor(d);
-                    alloc.push_back(adj);
-                    if (!closeList.has(adj)) {
-                        adj->setParent(cur);
-                        adj->setG(cur->getG() + 1);
-                        adj->setH(adj->heuristic(&end, index));
-                        openList.push(adj);
-                    }
-                }
+            if (next == NOT_FOUND) {
+                break;
             }
+            bound = next;
+        }
+        stats.expansions = searchCnt;
+        stats.seconds = secondsSince(start);
+    }
+
+    /*
+    Solve the puzzle with hash-distributed A* (HDA*) on several threads.
+    Each thread owns the nodes whose Zobrist hash maps to it, with its own
+    open list and closed set, and sends every node it generates to the
+    owner through a lock-free queue. The threads stop when a solution is
+    found and no thread holds or receives a node with a smaller f value,
+    so the path is as short as the one of solve().
+    Reference: Kishimoto et al., Scalable, Parallel Best-First Search for
+    Optimal Sequential Planning, ICAPS'09.
+
+    The search count is the total amount of expanded nodes. It may differ
+    between runs since the threads race each other.
+
+    @param threads The amount of threads (at least one thread is used)
+    */
+    void solveHDAStar(const SizeType threads = std::thread::hardware_concurrency()) {
+        searchCnt = 0;
+        stats = Stats();
+        path.clear();
+        if (!isReachable()) {
+            return;
+        }
+        auto start = std::chrono::steady_clock::now();
+        const std::vector<std::uint8_t> dist = buildDistance();
+        HDAShared shared(std::max(threads, (SizeType)1));
+        for (SizeType i = 0; i < shared.workers.size(); ++i) {
+            shared.workers[i].reset(new HDAWorker());
+        }
+
+        // The beginning node is sent by this thread
+        HDAMessage begMsg(beg);
+        Node &begNode = begMsg.node;
+        begNode.setParent(nullptr);
+        begNode.setG(0);
+        begNode.setH(heuristic ? heuristic(begNode) : begNode.heuristic(dist));
+        shared.work = 1;
+        shared.workers[hdaOwner(begNode, shared.workers.size())]->inbox.push(&begMsg);
+
+        std::vector<std::thread> ths;
+        for (SizeType i = 0; i < shared.workers.size(); ++i) {
+            ths.emplace_back([this, i, &shared, &dist] {
+                runHDAStar(i, shared, dist);
+            });
+        }
+        for (auto &t : ths) {
+            t.join();
+        }
+        for (const auto &w : shared.workers) {
+            searchCnt += w->expansions;
+            stats.peakClosed += w->best.size();
+            stats.allocatedBytes += w->arena.getUsedBytes();
         }
+        if (shared.goal) {
+            buildPath(shared.goal);
+        }
+        stats.expansions = searchCnt;
+        stats.seconds = secondsSince(start);
     }
 
     const std::list<Direc>& getPath() const {
@@ -334,6 +496,28 @@ public:
         return searchCnt;
     }
 
+    // Return the statistics of the last search
+    const Stats& getStats() const noexcept {
+        return stats;
+    }
+
+    // Return the size in bytes of a node of the A* search of solve()
+    static SizeType getSearchNodeSize() noexcept {
+        return sizeof(typename Engine<HeapOpenList>::Node);
+    }
+
+    /*
+    Report the statistics periodically during solve().
+
+    @param progress The function called with the statistics
+    @param interval The amount of expansions between two calls,
+                    zero or an empty function to stop reporting
+    */
+    void setProgress(const Progress& progress, const SizeType interval) {
+        heapSearch.setProgress(progress, interval);
+        bucketSearch.setProgress(progress, interval);
+    }
+
     const Node& shuffleBeg() {
         beg.shuffle();
         return beg;
@@ -360,15 +544,269 @@ public:
         return end;
     }
 
+    /*
+    Choose the open list of solve(). With a bucket queue the nodes with
+    the same f value are expanded deepest first, which usually reaches
+    the ending node with fewer expansions than the heap.
+
+    @param t The type of the open list, HEAP by default
+    */
+    void setOpenListType(const OpenListType t) noexcept {
+        openListType = t;
+    }
+
+    /*
+    Replace the default heuristic (sum of Manhattan distances).
+
+    @param h The heuristic to the ending node. An empty function
+             restores the default one.
+    */
+    void setHeuristic(Heuristic h) {
+        heuristic = std::move(h);
+    }
+
 private:
-    // Return the index of the grid numbers in the ending node value.
-    std::vector<SizeType> buildIndex() const {
-        const auto &endVal = end.getVal();
-        std::vector<SizeType> index(endVal.size());
-        for (SizeType i = 0; i < endVal.size(); ++i) {
-            index[endVal[i]] = i;
+    struct Less;
+    struct HDAWorker;
+    struct HDAShared;
+
+    // Return the distance table of the ending node, see PuzzleNode::heuristic()
+    std::vector<std::uint8_t> buildDistance() const {
+        SizeType size = end.getGridCount();
+        std::vector<std::uint8_t> dist(size * size);
+        for (SizeType j = 0; j < size; ++j) {
+            SizeType num = end.getNum(j);
+            for (SizeType i = 0; i < size; ++i) {
+                SizeType dR = end.getRow(i) > end.getRow(j) ? end.getRow(i) - end.getRow(j)
+                                                            : end.getRow(j) - end.getRow(i);
+                SizeType dC = end.getCol(i) > end.getCol(j) ? end.getCol(i) - end.getCol(j)
+                                                            : end.getCol(j) - end.getCol(i);
+                dist[num * size + i] = (std::uint8_t)(dR + dC);
+            }
+        }
+        return dist;
+    }
+
+    // Run solve() upon an A* engine
+    template<typename Engine>
+    void searchAStar(Engine& engine, const std::vector<std::uint8_t>& dist) {
+        engine.getExpand() = Expander{&dist, &heuristic, &end};
+        bool found = engine.search(toState(beg), toState(end));
+        stats = engine.getStats();
+        searchCnt = stats.expansions;
+        if (found) {
+            for (auto n = engine.getGoal(); n->parent; n = n->parent) {
+                Node cur = toNode(n->state, end), prev = toNode(n->parent->state, end);
+                path.push_front(cur.getDirectionTo(&prev));
+            }
+        }
+        engine.clear();
+    }
+
+    /*
+    Return true if the ending node can be reached from the beginning node.
+    On a board with at least two rows and columns, this holds iff the
+    parity of the permutation between the two nodes equals the parity of
+    the distance between their empty grids.
+    */
+    bool isReachable() const {
+        SizeType size = end.getGridCount();
+        std::vector<SizeType> index(size);
+        for (SizeType i = 0; i < size; ++i) {
+            index[end.getNum(i)] = i;
+        }
+        if (end.getRowCount() == 1 || end.getColCount() == 1) {
+            // The numbers can only slide along the line
+            SizeType j = 0;
+            for (SizeType i = 0; i < size; ++i) {
+                if (beg.getNum(i)) {
+                    while (!end.getNum(j)) ++j;
+                    if (beg.getNum(i) != end.getNum(j++)) {
+                        return false;
+                    }
+                }
+            }
+            return true;
+        }
+        std::vector<SizeType> perm(size);
+        for (SizeType i = 0; i < size; ++i) {
+            perm[i] = index[beg.getNum(i)];
+        }
+        SizeType swaps = 0;
+        for (SizeType i = 0; i < size; ++i) {
+            while (perm[i] != i) {
+                std::swap(perm[i], perm[perm[i]]);
+                ++swaps;
+            }
+        }
+        SizeType b = beg.emptyPos, e = end.emptyPos;
+        SizeType dR = beg.getRow(b) > end.getRow(e) ? beg.getRow(b) - end.getRow(e)
+                                                    : end.getRow(e) - beg.getRow(b);
+        SizeType dC = beg.getCol(b) > end.getCol(e) ? beg.getCol(b) - end.getCol(e)
+                                                    : end.getCol(e) - beg.getCol(b);
+        return swaps % 2 == (dR + dC) % 2;
+    }
+
+    /*
+    One bounded depth-first search of IDA*.
+
+    @param cur   The current node, restored before returning
+    @param g     The cost from the beginning node to the current node
+    @param bound The largest f value to be expanded
+    @param prev  The direction of the last move
+    @param dist  The distance table
+    @param stack The moves from the beginning node to the current node
+    @return      FOUND if the ending node is reached, otherwise the
+                 smallest f value exceeding the bound, or NOT_FOUND if
+                 there is no such value
+    */
+    SizeType searchIDAStar(Node& cur, const SizeType g, const SizeType bound, const Direc prev,
+                           const std::vector<std::uint8_t>& dist, std::vector<Direc>& stack) {
+        SizeType f = g + cur.getH();
+        if (f > bound) {
+            return f;
+        }
+        ++searchCnt;
+        if (cur == end) {
+            return FOUND;
+        }
+        SizeType res = NOT_FOUND;
+        for (int i = 1; i < 5; ++i) {
+            Direc d = Direc(i);
+            if (d == opposite(prev) || !cur.canMove(d)) {
+                continue;
+            }
+            SizeType h = cur.getH();
+            if (heuristic) {
+                cur.move(d);
+                cur.setH(heuristic(cur));
+            } else {
+                cur.move(d, dist);
+            }
+            stack.push_back(d);
+            SizeType next = searchIDAStar(cur, g + 1, bound, d, dist, stack);
+            if (next == FOUND) {
+                return FOUND;
+            }
+            stack.pop_back();
+            cur.move(opposite(d));
+            cur.setH(h);
+            res = std::min(res, next);
+        }
+        return res;
+    }
+
+    // Return the thread owning a node in HDA*
+    static SizeType hdaOwner(const Node& n, const SizeType threads) noexcept {
+        // The low bits select buckets of the closed sets, so use the high bits
+        return (SizeType)((n.hash() >> 32) % threads);
+    }
+
+    /*
+    The loop of one HDA* thread. A thread counts in 'work' while it is
+    active, and so does each message until it is received. Idle threads
+    don't send messages, so the search is over once 'work' drops to zero.
+    */
+    void runHDAStar(const SizeType index, HDAShared& shared, const std::vector<std::uint8_t>& dist) {
+        HDAWorker &self = *shared.workers[index];
+        const SizeType threads = shared.workers.size();
+        bool idle = true;
+        while (true) {
+            HDAMessage *msg = self.inbox.takeAll();
+            if (msg) {
+                if (idle) {
+                    ++shared.work;
+                    idle = false;
+                }
+                SizeType cnt = 0;
+                for (; msg; msg = msg->next, ++cnt) {
+                    receiveHDAStar(self, &msg->node, shared);
+                }
+                shared.work -= cnt;
+            }
+
+            if (!self.open.isEmpty()) {
+                if (idle) {
+                    ++shared.work;
+                    idle = false;
+                }
+                Node *cur = self.open.top();
+                self.open.pop();
+                if (self.best[cur] != cur || cur->getF() >= shared.incumbent.load()) {
+                    continue;  // Reached again with a smaller cost, or pruned
+                }
+                ++self.expansions;
+                if (*cur == end) {
+                    std::lock_guard<std::mutex> lock(shared.mtx);
+                    if (cur->getG() < shared.incumbent.load()) {
+                        shared.incumbent = cur->getG();
+                        shared.goal = cur;
+                    }
+                    continue;
+                }
+                for (int i = 1; i < 5; ++i) {
+                    Direc d = Direc(i);
+                    if (!cur->canMove(d)) {
+                        continue;
+                    }
+                    Node next = *cur;
+                    if (heuristic) {
+                        next.move(d);
+                        next.setH(heuristic(next));
+                    } else {
+                        next.move(d, dist);
+                    }
+                    if (cur->getParent() && next == *cur->getParent()) {
+                        continue;  // Skip the move back to the parent
+                    }
+                    next.setParent(cur);
+                    next.setG(cur->getG() + 1);
+                    HDAMessage *adj = self.arena.create<HDAMessage>(next);
+                    SizeType owner = hdaOwner(adj->node, threads);
+                    if (owner == index) {
+                        receiveHDAStar(self, &adj->node, shared);
+                    } else {
+                        ++shared.work;
+                        shared.workers[owner]->inbox.push(adj);
+                    }
+                }
+                continue;
+            }
+
+            if (!idle) {
+                idle = true;
+                --shared.work;
+            }
+            if (shared.work.load() == 0) {
+                return;
+            }
+            std::this_thread::yield();
+        }
+    }
+
+    // Put a node owned by a HDA* thread into its open list unless it is known with a smaller cost
+    static void receiveHDAStar(HDAWorker& self, Node *const n, const HDAShared& shared) {
+        if (n->getF() >= shared.incumbent.load()) {
+            return;
+        }
+        auto it = self.best.find(n);
+        if (it == self.best.end()) {
+            self.best.emplace(n, n);
+        } else if (n->getG() < it->second->getG()) {
+            it->second = n;
+        } else {
+            return;
         }
-        return index;
+        self.open.push(n);
+    }
+
+    static double secondsSince(const std::chrono::steady_clock::time_point start) {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    // Return the direction undoing a move along a given direction
+    static Direc opposite(const Direc d) noexcept {
+        return d == Direc::NONE ? Direc::NONE : Direc((d + 1) % 4 + 1);
     }
 
     // Build a path from the beginning node to the destination node
@@ -384,16 +822,10 @@ private:
         }
     }
 
-    void freeResources() {
-        for (const auto &n : alloc) {
-            delete n;
-        }
-        alloc.clear();
-        openList.clear();
-        closeList.clear();
-    }
-
 private:
+    static const SizeType FOUND = (SizeType)-1;
+    static const SizeType NOT_FOUND = (SizeType)-2;
+
     struct Equal {
         bool operator()(const Node *const &n1,
                         const Node *const &n2) const noexcept {
@@ -410,20 +842,139 @@ private:
 
     struct Hash {
         SizeType operator()(const Node *const &n) const noexcept {
-            return n->hash();
+            return (SizeType)n->hash();
+        }
+    };
+
+    /*
+    A state of solve(): the board of a node without its links, since the
+    A* engine keeps the parent and the costs in its own node. The size of
+    the board comes from the ending node.
+    */
+    struct SearchState {
+        Node::Board val;
+        std::uint64_t key;
+        std::uint32_t h;  // The heuristic value, computed when the state is generated
+        std::uint8_t emptyPos;
+
+        bool operator==(const SearchState& s) const noexcept {
+            return val == s.val;
+        }
+    };
+
+    static SearchState toState(const Node& n) noexcept {
+        return SearchState{n.val, n.key, n.h, n.emptyPos};
+    }
+
+    // Return the node of a state, with the size of a given node
+    static Node toNode(const SearchState& s, const Node& shape) noexcept {
+        Node n = shape;
+        n.val = s.val;
+        n.key = s.key;
+        n.h = s.h;
+        n.emptyPos = s.emptyPos;
+        return n;
+    }
+
+    /*
+    The successors of a state in solve(). Each successor carries its
+    heuristic value, so the A* engine reads it with Estimator.
+    */
+    struct Expander {
+        const std::vector<std::uint8_t> *dist;
+        const Heuristic *heuristic;
+        const Node *shape;
+
+        template<typename Emit>
+        void operator()(const SearchState& state, Emit&& emit) const {
+            const Node cur = toNode(state, *shape);
+            for (int i = 1; i < 5; ++i) {
+                Direc d = Direc(i);
+                if (cur.canMove(d)) {
+                    Node next = cur;
+                    if (*heuristic) {
+                        next.move(d);
+                        next.setH((*heuristic)(next));
+                    } else {
+                        next.move(d, *dist);
+                    }
+                    emit(toState(next), 1);
+                }
+            }
+        }
+    };
+
+    struct Estimator {
+        std::uint32_t operator()(const SearchState& s) const noexcept {
+            return s.h;
+        }
+    };
+
+    struct Hasher {
+        SizeType operator()(const SearchState& s) const noexcept {
+            return (SizeType)s.key;
+        }
+    };
+
+    template<template<typename> class OpenList>
+    using Engine = AStar<SearchState, Expander, Estimator, Hasher, std::equal_to<SearchState>, OpenList>;
+
+    // A node sent between HDA* threads
+    struct HDAMessage {
+        explicit HDAMessage(const Node& n) : node(n) {}
+
+        Node node;
+        HDAMessage *next = nullptr;
+    };
+
+    // A lock-free queue with many producers and one consumer
+    struct HDAInbox {
+        std::atomic<HDAMessage*> head{nullptr};
+
+        void push(HDAMessage *const msg) noexcept {
+            msg->next = head.load(std::memory_order_relaxed);
+            while (!head.compare_exchange_weak(msg->next, msg, std::memory_order_release,
+                                               std::memory_order_relaxed)) {}
+        }
+
+        // Take all messages, the latest one first
+        HDAMessage* takeAll() noexcept {
+            return head.exchange(nullptr, std::memory_order_acquire);
         }
     };
 
+    // The data owned by one HDA* thread
+    struct HDAWorker {
+        HDAInbox inbox;
+        Arena arena;  // Generated nodes
+        BinaryHeap<Node*, Less> open;
+        std::unordered_map<Node*, Node*, Hash, Equal> best;  // The node with the smallest g of each value
+        SizeType expansions = 0;
+    };
+
+    // The data shared by all HDA* threads
+    struct HDAShared {
+        explicit HDAShared(const SizeType n) : workers(n) {}
+
+        std::vector<std::unique_ptr<HDAWorker>> workers;
+        std::atomic<SizeType> work{0};  // Active threads plus messages not yet received
+        std::atomic<SizeType> incumbent{NOT_FOUND};  // Cost of the best solution so far
+        std::mutex mtx;
+        const Node *goal = nullptr;
+    };
+
     Node beg;
     Node end;
+    Heuristic heuristic;
 
-    BinaryHeap<Node*, Less> openList;
-    HashTable<Node*, Equal, Hash> closeList;
+    OpenListType openListType = HEAP;
+    Engine<HeapOpenList> heapSearch;
+    Engine<BucketOpenList> bucketSearch;
 
     std::list<Direc> path;
-    std::list<Node*> alloc;
 
     SizeType searchCnt = 0;
+    Stats stats;
 };
 
 JUMBLE_NAMESPACE_END
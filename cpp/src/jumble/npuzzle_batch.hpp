@@ -0,0 +1,150 @@
+#ifndef JUMBLE_NPUZZLE_BATCH_HPP_INCLUDED
+#define JUMBLE_NPUZZLE_BATCH_HPP_INCLUDED
+
+#include "jumble/npuzzle.hpp"
+#include "jumble/util/thread_pool.hpp"
+#include <vector>
+#include <list>
+#include <memory>
+#include <future>
+#include <chrono>
+#include <utility>
+#include <cstdint>
+
+JUMBLE_NAMESPACE_BEGIN
+
+/*
+A solver of many independent N-Puzzle instances in parallel.
+
+Each instance is one task of a work-stealing thread pool, so workers
+finishing easy instances take over queued hard ones. Every worker
+thread keeps its own NPuzzle object, whose search structures are reused
+by all instances it solves instead of being rebuilt per instance.
+*/
+class NPuzzleBatch {
+public:
+    using Node = PuzzleNode;
+    using SizeType = Node::SizeType;
+    using Instance = std::pair<Node, Node>;  // The beginning and ending nodes
+
+    enum Algorithm {
+        ASTAR,    // See NPuzzle::solve()
+        IDA_STAR  // See NPuzzle::solveIDAStar()
+    };
+
+    // The result of one instance
+    struct Result {
+        std::list<Direc> path;  // Empty if the ending node is not reachable
+        SizeType searchCount = 0;
+        double seconds = 0;
+    };
+
+    // Statistics of the last batch
+    struct Stats {
+        SizeType instances = 0;
+        std::uint64_t expansions = 0;  // Total search count
+        double seconds = 0;            // Wall time to solve the batch
+
+        double instancesPerSecond() const noexcept {
+            return seconds > 0 ? instances / seconds : 0;
+        }
+
+        double expansionsPerSecond() const noexcept {
+            return seconds > 0 ? expansions / seconds : 0;
+        }
+    };
+
+    /*
+    Initialize the solver.
+
+    @param pool_ The threads to solve the instances
+    @param algo_ The search algorithm
+    */
+    explicit NPuzzleBatch(ThreadPool& pool_, const Algorithm algo_ = ASTAR)
+        : pool(pool_), algo(algo_), solvers(pool_.getSize()) {}
+
+    /*
+    Replace the default heuristic of every instance, see NPuzzle::setHeuristic().
+    The heuristic is called from all worker threads at the same time.
+    */
+    void setHeuristic(NPuzzle::Heuristic h) {
+        heuristic = std::move(h);
+        for (auto &s : solvers) {
+            if (s) {
+                s->setHeuristic(heuristic);
+            }
+        }
+    }
+
+    /*
+    Solve a batch of instances.
+    Precondition: not called from a worker thread of the pool.
+
+    @param instances The instances
+    @return          The result of each instance in the same order
+    @throw           The first exception thrown by solving an instance
+    */
+    std::vector<Result> solve(const std::vector<Instance>& instances) {
+        auto start = std::chrono::steady_clock::now();
+        std::vector<Result> res(instances.size());
+        std::vector<std::future<void>> futures;
+        futures.reserve(instances.size());
+        for (SizeType i = 0; i < instances.size(); ++i) {
+            futures.push_back(pool.submit([this, i, &instances, &res] {
+                solveOne(instances[i], res[i]);
+            }));
+        }
+        for (auto &fut : futures) {
+            fut.wait();
+        }
+        for (auto &fut : futures) {
+            fut.get();
+        }
+
+        stats.instances = instances.size();
+        stats.expansions = 0;
+        for (const auto &r : res) {
+            stats.expansions += r.searchCount;
+        }
+        stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        return res;
+    }
+
+    // Return the statistics of the last batch
+    const Stats& getStats() const noexcept {
+        return stats;
+    }
+
+private:
+    // Solve an instance with the NPuzzle object of the calling worker
+    void solveOne(const Instance& inst, Result& res) {
+        auto start = std::chrono::steady_clock::now();
+        std::unique_ptr<NPuzzle> &solver = solvers[pool.getWorkerIndex()];
+        if (!solver) {
+            solver.reset(new NPuzzle(inst.first, inst.second));
+            solver->setHeuristic(heuristic);
+        } else {
+            solver->setBeg(inst.first);
+            solver->setEnd(inst.second);
+        }
+        if (algo == IDA_STAR) {
+            solver->solveIDAStar();
+        } else {
+            solver->solve();
+        }
+        res.path = solver->getPath();
+        res.searchCount = solver->getSearchCount();
+        res.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+private:
+    ThreadPool &pool;
+    Algorithm algo;
+    NPuzzle::Heuristic heuristic;
+    std::vector<std::unique_ptr<NPuzzle>> solvers;  // One per worker thread
+    Stats stats;
+};
+
+JUMBLE_NAMESPACE_END
+
+#endif
@@ -0,0 +1,456 @@
+#ifndef JUMBLE_PATTERN_DATABASE_HPP_INCLUDED
+#define JUMBLE_PATTERN_DATABASE_HPP_INCLUDED
+
+#include "jumble/npuzzle.hpp"
+#include "jumble/util/mapped_file.hpp"
+#include <vector>
+#include <string>
+#include <memory>
+#include <fstream>
+#include <stdexcept>
+#include <algorithm>
+#include <cstring>
+#include <cstdint>
+
+JUMBLE_NAMESPACE_BEGIN
+
+/*
+Additive disjoint pattern databases for the N-Puzzle.
+Reference: Felner et al., Additive Pattern Database Heuristics, JAIR'04.
+
+The numbers are split into disjoint groups. For each group, a table
+stores the least amount of moves of the group's numbers needed to bring
+them to their destinations from every placement, regardless of the other
+numbers. Moves of the other numbers are free, so the values of different
+groups can be added up without overestimating the distance.
+
+Tables are built once by a backward breadth-first search from the
+ending node, then written to a file which is mapped into memory when
+loaded. A group of k numbers on n grids takes n!/(n-k)! bytes, e.g.
+about 550 MB for the 7-8 partitioning of the 15-puzzle. The search
+additionally needs n bits per entry while building.
+
+The heuristic value is the larger one of the pattern database sum and
+the Manhattan distance with linear conflicts, both being admissible.
+*/
+class PatternDatabase {
+public:
+    using Node = PuzzleNode;
+    using SizeType = Node::SizeType;
+    using Groups = std::vector<std::vector<int>>;
+
+    static const std::uint32_t VERSION = 1;
+
+    /*
+    Build the pattern databases.
+
+    @param goal   The ending node
+    @param groups The disjoint groups of numbers. Number '0' (the empty
+                  grid) must not be included. Numbers in no group are
+                  only counted by the Manhattan distance.
+    @throw std::invalid_argument if the groups are invalid
+    */
+    PatternDatabase(const Node& goal, const Groups& groups) : goalNode(goal) {
+        std::memset(&header, 0, sizeof(header));
+        std::memcpy(header.magic, MAGIC, sizeof(header.magic));
+        header.version = VERSION;
+        header.rows = (std::uint32_t)goal.getRowCount();
+        header.cols = (std::uint32_t)goal.getColCount();
+        header.groupCount = (std::uint32_t)groups.size();
+        for (SizeType i = 0; i < goal.getGridCount(); ++i) {
+            header.goal[i] = (std::uint8_t)goal.getNum(i);
+        }
+        std::memset(header.group, NO_GROUP, sizeof(header.group));
+        for (SizeType g = 0; g < groups.size(); ++g) {
+            if (groups[g].empty()) {
+                throw std::invalid_argument("empty pattern group");
+            }
+            for (const auto &num : groups[g]) {
+                if (num <= 0 || (SizeType)num >= goal.getGridCount() || header.group[num] != NO_GROUP) {
+                    throw std::invalid_argument("invalid pattern number " + std::to_string(num));
+                }
+                header.group[num] = (std::uint8_t)g;
+            }
+        }
+        init();
+
+        auto tables = std::make_shared<std::vector<std::uint8_t>>();
+        std::vector<SizeType> offsets;
+        for (const auto &p : patterns) {
+            offsets.push_back(tables->size());
+            std::vector<std::uint8_t> t = buildTable(p);
+            tables->insert(tables->end(), t.begin(), t.end());
+        }
+        for (SizeType g = 0; g < patterns.size(); ++g) {
+            patterns[g].table = tables->data() + offsets[g];
+        }
+        owner = std::move(tables);
+    }
+
+    /*
+    Map pattern databases written by write().
+
+    @param path The path of the file
+    @throw std::runtime_error if the file cannot be mapped or is invalid
+    */
+    explicit PatternDatabase(const std::string& path)
+        : PatternDatabase(std::make_shared<MappedFile>(path), path) {}
+
+    /*
+    Write the pattern databases to a file.
+
+    @param path The path of the file
+    @throw std::runtime_error if the file cannot be written
+    */
+    void write(const std::string& path) const {
+        std::ofstream ofs(path, std::ios::binary | std::ios::trunc);
+        if (!ofs) {
+            throw std::runtime_error("cannot open " + path);
+        }
+        writeSection(ofs, &header, sizeof(header));
+        for (const auto &p : patterns) {
+            writeSection(ofs, p.table, p.size);
+        }
+        if (!ofs.flush()) {
+            throw std::runtime_error("cannot write " + path);
+        }
+    }
+
+    // Return the ending node of the databases
+    const Node& getGoal() const noexcept {
+        return goalNode;
+    }
+
+    // Return the amount of groups
+    SizeType getGroupCount() const noexcept {
+        return patterns.size();
+    }
+
+    /*
+    Return the sum of the pattern database values of a node.
+    Precondition: the node has the same size as the ending node
+    */
+    SizeType getPatternDistance(const Node& node) const noexcept {
+        std::uint8_t pos[Node::MAX_GRIDS];
+        for (SizeType i = 0; i < node.getGridCount(); ++i) {
+            pos[node.getNum(i)] = (std::uint8_t)i;
+        }
+        SizeType res = 0;
+        std::uint8_t cells[Node::MAX_GRIDS];
+        for (const auto &p : patterns) {
+            for (SizeType j = 0; j < p.tiles.size(); ++j) {
+                cells[j] = pos[p.tiles[j]];
+            }
+            res += p.table[rank(cells, p.tiles.size())];
+        }
+        return res;
+    }
+
+    /*
+    Return the Manhattan distance of a node plus two moves for each
+    number that must leave its line to let the other numbers in the
+    same row (or column) pass, computed with the longest increasing
+    subsequence of their destinations.
+    Reference: Hansson et al., Generating Admissible Heuristics by
+    Criticizing Solutions to Relaxed Models, 1985.
+
+    Precondition: the node has the same size as the ending node
+    */
+    SizeType getLinearConflictDistance(const Node& node) const noexcept {
+        const SizeType rows = header.rows, cols = header.cols;
+        SizeType res = 0;
+        for (SizeType i = 0; i < node.getGridCount(); ++i) {
+            SizeType num = node.getNum(i);
+            if (num) {
+                SizeType r = i / cols, c = i % cols;
+                SizeType gr = goalPos[num] / cols, gc = goalPos[num] % cols;
+                res += (r > gr ? r - gr : gr - r) + (c > gc ? c - gc : gc - c);
+            }
+        }
+        std::uint8_t line[Node::MAX_GRIDS];
+        for (SizeType r = 0; r < rows; ++r) {
+            SizeType cnt = 0;
+            for (SizeType c = 0; c < cols; ++c) {
+                SizeType num = node.getNum(r * cols + c);
+                if (num && goalPos[num] / cols == r) {
+                    line[cnt++] = (std::uint8_t)(goalPos[num] % cols);
+                }
+            }
+            res += 2 * (cnt - increasingLength(line, cnt));
+        }
+        for (SizeType c = 0; c < cols; ++c) {
+            SizeType cnt = 0;
+            for (SizeType r = 0; r < rows; ++r) {
+                SizeType num = node.getNum(r * cols + c);
+                if (num && goalPos[num] % cols == c) {
+                    line[cnt++] = (std::uint8_t)(goalPos[num] / cols);
+                }
+            }
+            res += 2 * (cnt - increasingLength(line, cnt));
+        }
+        return res;
+    }
+
+    /*
+    Return the heuristic value of a node, usable by NPuzzle::setHeuristic().
+    Precondition: the node has the same size as the ending node
+    */
+    SizeType operator()(const Node& node) const noexcept {
+        return std::max(getPatternDistance(node), getLinearConflictDistance(node));
+    }
+
+private:
+    static const SizeType MAX_GROUP_SLOTS = 32;
+    static const std::uint8_t NO_GROUP = 0xff;
+    static const std::uint8_t UNKNOWN = 0xff;
+    static const std::size_t ALIGNMENT = 8;
+
+    struct Header {
+        char magic[8];
+        std::uint32_t version;
+        std::uint32_t rows;
+        std::uint32_t cols;
+        std::uint32_t groupCount;
+        std::uint8_t goal[MAX_GROUP_SLOTS];   // The ending node value
+        std::uint8_t group[MAX_GROUP_SLOTS];  // The group of each number, or NO_GROUP
+        std::uint64_t reserved;
+    };
+
+    // The table of one group
+    struct Pattern {
+        std::vector<std::uint8_t> tiles;  // Numbers in ascending order
+        SizeType size;                    // Amount of entries, n!/(n-k)!
+        const std::uint8_t *table;
+    };
+
+    static constexpr const char *MAGIC = "JMBPATDB";
+
+    // Set up the databases of a mapped file, which is mapped only once
+    PatternDatabase(std::shared_ptr<MappedFile> file, const std::string& path)
+        : goalNode(loadGoal(*file, path, header)) {
+        init();
+        std::uint64_t off = align(sizeof(header));
+        for (auto &p : patterns) {
+            if (file->getSize() < off + p.size) {
+                throw std::runtime_error("truncated pattern database " + path);
+            }
+            p.table = file->data() + off;
+            off = align(off + p.size);
+        }
+        owner = std::move(file);
+    }
+
+    // Read and validate the header of a mapped file, then return its ending node
+    static Node loadGoal(const MappedFile& file, const std::string& path, Header& header) {
+        if (file.getSize() < sizeof(header)) {
+            throw std::runtime_error("truncated pattern database " + path);
+        }
+        std::memcpy(&header, file.data(), sizeof(header));
+        if (std::memcmp(header.magic, MAGIC, sizeof(header.magic)) != 0) {
+            throw std::runtime_error("not a pattern database " + path);
+        }
+        if (header.version != VERSION) {
+            throw std::runtime_error("unsupported pattern database version " + std::to_string(header.version));
+        }
+        SizeType n = (SizeType)header.rows * header.cols;
+        if (n == 0 || n > Node::MAX_GRIDS || header.groupCount > n) {
+            throw std::runtime_error("invalid pattern database " + path);
+        }
+        std::vector<int> val(header.goal, header.goal + n);
+        std::vector<bool> seen(header.groupCount, false);
+        for (SizeType num = 0; num < n; ++num) {
+            std::uint8_t g = header.group[num];
+            if (g != NO_GROUP) {
+                if (num == 0 || g >= header.groupCount) {
+                    throw std::runtime_error("invalid pattern database " + path);
+                }
+                seen[g] = true;
+            }
+        }
+        if (std::find(seen.begin(), seen.end(), false) != seen.end()) {
+            throw std::runtime_error("invalid pattern database " + path);
+        }
+        try {
+            return Node(val, header.rows, header.cols);
+        } catch (const std::invalid_argument&) {
+            throw std::runtime_error("invalid pattern database " + path);
+        }
+    }
+
+    // Set up the destinations and the groups from the header
+    void init() {
+        SizeType n = goalNode.getGridCount();
+        for (SizeType i = 0; i < n; ++i) {
+            goalPos[goalNode.getNum(i)] = (std::uint8_t)i;
+        }
+        patterns.assign(header.groupCount, Pattern());
+        for (SizeType num = 1; num < n; ++num) {
+            if (header.group[num] != NO_GROUP) {
+                patterns[header.group[num]].tiles.push_back((std::uint8_t)num);
+            }
+        }
+        for (auto &p : patterns) {
+            p.size = 1;
+            for (SizeType j = 0; j < p.tiles.size(); ++j) {
+                p.size *= n - j;
+            }
+            p.table = nullptr;
+        }
+    }
+
+    /*
+    Return the index of distinct cells in a table. Each cell is replaced
+    by its rank among the cells not yet used, giving a number in mixed
+    radix n, n - 1, ..., n - k + 1.
+
+    @param cells The cells of the numbers in a group
+    @param k     The amount of numbers in the group
+    */
+    SizeType rank(const std::uint8_t *const cells, const SizeType k) const noexcept {
+        SizeType n = goalNode.getGridCount(), res = 0;
+        std::uint32_t used = 0;
+        for (SizeType j = 0; j < k; ++j) {
+            SizeType digit = cells[j] - (SizeType)__builtin_popcount(used & ((1u << cells[j]) - 1));
+            res = res * (n - j) + digit;
+            used |= 1u << cells[j];
+        }
+        return res;
+    }
+
+    // The inverse of rank()
+    void unrank(SizeType idx, std::uint8_t *const cells, const SizeType k) const noexcept {
+        SizeType n = goalNode.getGridCount();
+        std::uint8_t digits[Node::MAX_GRIDS];
+        for (SizeType j = k; j-- > 0;) {
+            digits[j] = (std::uint8_t)(idx % (n - j));
+            idx /= n - j;
+        }
+        std::uint32_t used = 0;
+        for (SizeType j = 0; j < k; ++j) {
+            SizeType c = 0;
+            for (SizeType skip = digits[j];; ++c) {
+                if (!(used & (1u << c)) && skip-- == 0) {
+                    break;
+                }
+            }
+            cells[j] = (std::uint8_t)c;
+            used |= 1u << c;
+        }
+    }
+
+    /*
+    Build the table of a group by breadth-first search from the ending
+    node. A state is a placement of the group plus the empty grid, and
+    the empty grid moves freely among the grids not in the group. So
+    each state is expanded by flooding its free region at once, and
+    only moving a number in the group takes the search one level deeper.
+    */
+    std::vector<std::uint8_t> buildTable(const Pattern& p) const {
+        const SizeType n = goalNode.getGridCount(), k = p.tiles.size();
+        const SizeType rows = header.rows, cols = header.cols;
+        std::vector<std::uint8_t> table(p.size, (std::uint8_t)UNKNOWN);
+        std::vector<std::uint64_t> visited((p.size * n + 63) / 64, 0);
+        auto isVisited = [&](const SizeType s) {
+            return (visited[s >> 6] >> (s & 63)) & 1;
+        };
+
+        std::uint8_t cells[Node::MAX_GRIDS];
+        for (SizeType j = 0; j < k; ++j) {
+            cells[j] = goalPos[p.tiles[j]];
+        }
+        std::vector<SizeType> cur(1, rank(cells, k) * n + goalPos[0]), next;
+        std::uint8_t owner[Node::MAX_GRIDS];
+        SizeType stack[Node::MAX_GRIDS];
+        for (SizeType dist = 0; !cur.empty(); ++dist) {
+            for (const auto &state : cur) {
+                if (isVisited(state)) {
+                    continue;
+                }
+                SizeType idx = state / n;
+                unrank(idx, cells, k);
+                std::uint32_t occupied = 0;
+                for (SizeType j = 0; j < k; ++j) {
+                    occupied |= 1u << cells[j];
+                    owner[cells[j]] = (std::uint8_t)j;
+                }
+                if (table[idx] == UNKNOWN) {
+                    table[idx] = (std::uint8_t)std::min<SizeType>(dist, UNKNOWN - 1);
+                }
+
+                // Flood the region of the empty grid
+                SizeType top = 0;
+                stack[top++] = state % n;
+                std::uint32_t region = 1u << (state % n);
+                while (top) {
+                    SizeType c = stack[--top];
+                    std::size_t s = idx * n + c;
+                    visited[s >> 6] |= std::uint64_t(1) << (s & 63);
+                    SizeType adj[4], cnt = 0;
+                    if (c % cols != 0) adj[cnt++] = c - 1;
+                    if (c % cols != cols - 1) adj[cnt++] = c + 1;
+                    if (c / cols != 0) adj[cnt++] = c - cols;
+                    if (c / cols != rows - 1) adj[cnt++] = c + cols;
+                    for (SizeType a = 0; a < cnt; ++a) {
+                        std::uint32_t bit = 1u << adj[a];
+                        if (occupied & bit) {
+                            // Move the number into the empty grid
+                            SizeType j = owner[adj[a]];
+                            cells[j] = (std::uint8_t)c;
+                            SizeType s2 = rank(cells, k) * n + adj[a];
+                            cells[j] = (std::uint8_t)adj[a];
+                            if (!isVisited(s2)) {
+                                next.push_back(s2);
+                            }
+                        } else if (!(region & bit)) {
+                            region |= bit;
+                            stack[top++] = adj[a];
+                        }
+                    }
+                }
+            }
+            cur.swap(next);
+            next.clear();
+        }
+        return table;
+    }
+
+    // Return the length of the longest increasing subsequence of distinct values
+    static SizeType increasingLength(const std::uint8_t *const vals, const SizeType cnt) noexcept {
+        std::uint8_t tails[Node::MAX_GRIDS];
+        SizeType len = 0;
+        for (SizeType i = 0; i < cnt; ++i) {
+            SizeType pos = (SizeType)(std::lower_bound(tails, tails + len, vals[i]) - tails);
+            tails[pos] = vals[i];
+            if (pos == len) {
+                ++len;
+            }
+        }
+        return len;
+    }
+
+    // Return the smallest offset no less than 'off' that is aligned
+    static std::uint64_t align(const std::uint64_t off) noexcept {
+        return (off + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+    }
+
+    // Pad the stream to the alignment and write 'len' bytes
+    static void writeSection(std::ofstream& ofs, const void *const data, const std::size_t len) {
+        static const char zeros[ALIGNMENT] = {0};
+        std::uint64_t pos = (std::uint64_t)ofs.tellp();
+        ofs.write(zeros, (std::streamsize)(align(pos) - pos));
+        if (len) {
+            ofs.write(static_cast<const char*>(data), (std::streamsize)len);
+        }
+    }
+
+private:
+    Header header;
+    Node goalNode;
+    std::uint8_t goalPos[Node::MAX_GRIDS];  // The destination of each number
+    std::vector<Pattern> patterns;
+    std::shared_ptr<const void> owner;  // Keeps the tables alive
+};
+
+JUMBLE_NAMESPACE_END
+
+#endif
@@ -0,0 +1,343 @@
+#ifndef JUMBLE_SHA256_HPP_INCLUDED
+#define JUMBLE_SHA256_HPP_INCLUDED
+
+#include "jumble/util/common.hpp"
+#include "jumble/util/hex.hpp"
+#include <string>
+#include <stdexcept>
+#include <cstring>
+#include <cstddef>
+#include <cstdint>
+#ifdef JUMBLE_X86_SIMD
+#include <immintrin.h>
+#endif
+
+JUMBLE_NAMESPACE_BEGIN
+
+namespace detail {
+
+// The round constants of SHA-256
+inline const std::uint32_t* sha256Constants() noexcept {
+    alignas(16) static const std::uint32_t K[64] = {
+        0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+        0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+        0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+        0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+        0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+        0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+        0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+        0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+    };
+    return K;
+}
+
+inline std::uint32_t sha256Rotate(const std::uint32_t x, const int n) noexcept {
+    return (x >> n) | (x << (32 - n));
+}
+
+inline void sha256Portable(std::uint32_t *const state, const unsigned char *p, std::size_t blocks) noexcept {
+    const std::uint32_t *const K = sha256Constants();
+    std::uint32_t st[8];
+    std::memcpy(st, state, sizeof(st));
+    for (; blocks; --blocks, p += 64) {
+        // The message schedule, the first 16 words are the big-endian block
+        std::uint32_t w[64];
+        for (int i = 0; i < 16; ++i) {
+            w[i] = (std::uint32_t)p[i * 4] << 24 | (std::uint32_t)p[i * 4 + 1] << 16
+                   | (std::uint32_t)p[i * 4 + 2] << 8 | (std::uint32_t)p[i * 4 + 3];
+        }
+        for (int i = 16; i < 64; ++i) {
+            std::uint32_t s0 = sha256Rotate(w[i - 15], 7) ^ sha256Rotate(w[i - 15], 18) ^ (w[i - 15] >> 3);
+            std::uint32_t s1 = sha256Rotate(w[i - 2], 17) ^ sha256Rotate(w[i - 2], 19) ^ (w[i - 2] >> 10);
+            w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+        }
+        std::uint32_t a = st[0], b = st[1], c = st[2], d = st[3];
+        std::uint32_t e = st[4], f = st[5], g = st[6], h = st[7];
+        for (int i = 0; i < 64; ++i) {
+            std::uint32_t t1 = h + (sha256Rotate(e, 6) ^ sha256Rotate(e, 11) ^ sha256Rotate(e, 25))
+                               + ((e & f) ^ (~e & g)) + K[i] + w[i];
+            std::uint32_t t2 = (sha256Rotate(a, 2) ^ sha256Rotate(a, 13) ^ sha256Rotate(a, 22))
+                               + ((a & b) ^ (a & c) ^ (b & c));
+            h = g;
+            g = f;
+            f = e;
+            e = d + t1;
+            d = c;
+            c = b;
+            b = a;
+            a = t1 + t2;
+        }
+        st[0] += a;
+        st[1] += b;
+        st[2] += c;
+        st[3] += d;
+        st[4] += e;
+        st[5] += f;
+        st[6] += g;
+        st[7] += h;
+    }
+    std::memcpy(state, st, sizeof(st));
+}
+
+#ifdef JUMBLE_X86_SIMD
+
+/*
+Process blocks with the SHA extensions. SHA256RNDS2 runs two rounds on
+the state split as ABEF and CDGH, and SHA256MSG1/MSG2 extend the message
+schedule four words at a time.
+Reference: Intel, New Instructions Supporting the Secure Hash Algorithm on Intel Architecture Processors.
+*/
+__attribute__((target("sha,sse4.1")))
+inline void sha256SHANI(std::uint32_t *const state, const unsigned char *p, std::size_t blocks) noexcept {
+    const std::uint32_t *const K = sha256Constants();
+    const __m128i byteSwap = _mm_set_epi64x(0x0c0d0e0f08090a0bLL, 0x0405060700010203LL);
+
+    __m128i tmp = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(state)), 0xb1);
+    __m128i cdgh = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(state + 4)), 0x1b);
+    __m128i abef = _mm_alignr_epi8(tmp, cdgh, 8);
+    cdgh = _mm_blend_epi16(cdgh, tmp, 0xf0);
+
+    for (; blocks; --blocks, p += 64) {
+        const __m128i abefSave = abef, cdghSave = cdgh;
+        __m128i msg[4];
+        // 16 groups of 4 rounds, msg[g % 4] holds the schedule words of group 'g'
+#pragma GCC unroll 16
+        for (int g = 0; g < 16; ++g) {
+            if (g < 4) {
+                msg[g] = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p + g * 16)), byteSwap);
+            }
+            __m128i wk = _mm_add_epi32(msg[g % 4], _mm_load_si128(reinterpret_cast<const __m128i*>(K + g * 4)));
+            cdgh = _mm_sha256rnds2_epu32(cdgh, abef, wk);
+            if (g >= 3 && g < 15) {
+                __m128i &next = msg[(g + 1) % 4];
+                next = _mm_add_epi32(next, _mm_alignr_epi8(msg[g % 4], msg[(g + 3) % 4], 4));
+                next = _mm_sha256msg2_epu32(next, msg[g % 4]);
+            }
+            abef = _mm_sha256rnds2_epu32(abef, cdgh, _mm_shuffle_epi32(wk, 0x0e));
+            if (g >= 1 && g < 13) {
+                msg[(g + 3) % 4] = _mm_sha256msg1_epu32(msg[(g + 3) % 4], msg[g % 4]);
+            }
+        }
+        abef = _mm_add_epi32(abef, abefSave);
+        cdgh = _mm_add_epi32(cdgh, cdghSave);
+    }
+
+    tmp = _mm_shuffle_epi32(abef, 0x1b);
+    cdgh = _mm_shuffle_epi32(cdgh, 0xb1);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(state), _mm_blend_epi16(tmp, cdgh, 0xf0));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(state + 4), _mm_alignr_epi8(cdgh, tmp, 8));
+}
+
+#endif
+
+using SHA256Func = void (*)(std::uint32_t*, const unsigned char*, std::size_t);
+
+}  // namespace detail
+
+/*
+An incremental SHA-256 computation, with the same interface as
+MD5Context. Blocks are processed with the SHA extensions of x86 CPUs
+if they are supported, or with portable code otherwise.
+*/
+class SHA256Context {
+public:
+    using UInt32 = std::uint32_t;
+    using UInt64 = std::uint64_t;
+    using SizeType = std::size_t;
+
+    static const SizeType BLOCK_SIZE = 64;
+    static const SizeType DIGEST_SIZE = 32;
+
+    enum Kernel {
+        PORTABLE,  // Any CPU
+        SHANI      // The SHA extensions of x86
+    };
+
+    // Return true if a kernel is compiled in and supported by the CPU
+    static bool isSupported(const Kernel k) noexcept {
+        return getFunc(k) != nullptr;
+    }
+
+    // Return the fastest supported kernel
+    static Kernel getBestKernel() noexcept {
+        return isSupported(SHANI) ? SHANI : PORTABLE;
+    }
+
+    /*
+    Initialize the context.
+
+    @param kernel_ The kernel, the fastest supported one by default
+    @throw std::invalid_argument if the kernel is not supported
+    */
+    explicit SHA256Context(const Kernel kernel_ = getBestKernel())
+        : kernel(kernel_), compress(getFunc(kernel_)) {
+        if (!compress) {
+            throw std::invalid_argument("SHA-256 kernel not supported");
+        }
+        reset();
+    }
+
+    Kernel getKernel() const noexcept {
+        return kernel;
+    }
+
+    // Start a new message
+    void reset() noexcept {
+        static const UInt32 INIT[8] = {0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+                                       0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19};
+        std::memcpy(state, INIT, sizeof(state));
+        total = 0;
+        used = 0;
+    }
+
+    /*
+    Append data to the message.
+
+    @param data The data
+    @param len  The amount of bytes
+    */
+    void update(const void *const data, SizeType len) noexcept {
+        const unsigned char *p = static_cast<const unsigned char*>(data);
+        total += len;
+        if (used) {
+            SizeType n = BLOCK_SIZE - used < len ? BLOCK_SIZE - used : len;
+            std::memcpy(buffer + used, p, n);
+            used += n;
+            p += n;
+            len -= n;
+            if (used < BLOCK_SIZE) {
+                return;
+            }
+            compress(state, buffer, 1);
+            used = 0;
+        }
+        if (len >= BLOCK_SIZE) {
+            compress(state, p, len / BLOCK_SIZE);
+            p += len / BLOCK_SIZE * BLOCK_SIZE;
+            len %= BLOCK_SIZE;
+        }
+        if (len) {
+            std::memcpy(buffer, p, len);
+            used = len;
+        }
+    }
+
+    /*
+    Finish the message and start a new one.
+
+    @param digest The buffer to store the DIGEST_SIZE bytes of the digest
+    */
+    void finalize(unsigned char *const digest) noexcept {
+        // Same padding as MD5, but the length is big-endian
+        unsigned char tail[BLOCK_SIZE + 8] = {0x80};
+        UInt64 bits = total << 3;
+        SizeType padLen = (used < 56 ? 56 : 120) - used;
+        for (int i = 0; i < 8; ++i) {
+            tail[padLen + i] = (unsigned char)(bits >> ((7 - i) * 8));
+        }
+        update(tail, padLen + 8);
+        for (SizeType i = 0; i < DIGEST_SIZE; ++i) {
+            digest[i] = (unsigned char)(state[i >> 2] >> ((3 - (i & 3)) << 3));
+        }
+        reset();
+    }
+
+    /*
+    Finish the message and start a new one.
+
+    @return The hashed string result
+    */
+    std::string finalize() {
+        unsigned char digest[DIGEST_SIZE];
+        finalize(digest);
+        return toHex(digest);
+    }
+
+    /*
+    Encode a digest in lowercase hexadecimal.
+
+    @param digest The DIGEST_SIZE bytes of the digest
+    @return       The hexadecimal string
+    */
+    static std::string toHex(const unsigned char *const digest) {
+        std::string res(DIGEST_SIZE * 2, '0');
+        jumble::toHex(digest, DIGEST_SIZE, &res[0]);
+        return res;
+    }
+
+private:
+    // Return the function of a kernel, or nullptr if it is not supported
+    static detail::SHA256Func getFunc(const Kernel k) noexcept {
+        switch (k) {
+            case PORTABLE:
+                return detail::sha256Portable;
+#ifdef JUMBLE_X86_SIMD
+            case SHANI:
+                __builtin_cpu_init();
+                if (__builtin_cpu_supports("sha") && __builtin_cpu_supports("sse4.1")) {
+                    return detail::sha256SHANI;
+                }
+                return nullptr;
+#endif
+            default:
+                return nullptr;
+        }
+    }
+
+private:
+    Kernel kernel;
+    detail::SHA256Func compress;
+    UInt32 state[8];   // a to h
+    UInt64 total;      // Length of the message in bytes
+    SizeType used;     // Bytes in the buffer
+    unsigned char buffer[BLOCK_SIZE];  // The partial block
+};
+
+/*
+SHA-256 of whole messages. All functions are static and keep no state,
+so they can be called from any amount of threads at the same time.
+*/
+class SHA256 {
+public:
+    SHA256() = delete;
+
+    /*
+    Hash a message.
+
+    @param msg The message to be hashed
+    @return    The hashed string result
+    */
+    static std::string hash(const std::string& msg) {
+        return hash(msg.data(), msg.size());
+    }
+
+    /*
+    Hash a message.
+
+    @param data The message to be hashed
+    @param len  The length of the message in bytes
+    @return     The hashed string result
+    */
+    static std::string hash(const void *const data, const SHA256Context::SizeType len) {
+        unsigned char digest[SHA256Context::DIGEST_SIZE];
+        hash(data, len, digest);
+        return SHA256Context::toHex(digest);
+    }
+
+    /*
+    Hash a message without allocating memory.
+
+    @param data   The message to be hashed
+    @param len    The length of the message in bytes
+    @param digest The buffer to store the SHA256Context::DIGEST_SIZE bytes of the digest
+    */
+    static void hash(const void *const data, const SHA256Context::SizeType len, unsigned char *const digest) noexcept {
+        SHA256Context ctx;
+        ctx.update(data, len);
+        ctx.finalize(digest);
+    }
+};
+
+JUMBLE_NAMESPACE_END
+
+#endif
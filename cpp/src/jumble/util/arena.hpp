@@ -0,0 +1,163 @@
+#ifndef JUMBLE_UTIL_ARENA_HPP_INCLUDED
+#define JUMBLE_UTIL_ARENA_HPP_INCLUDED
+
+#include "jumble/util/common.hpp"
+#include <vector>
+#include <memory>
+#include <new>
+#include <utility>
+#include <algorithm>
+#include <type_traits>
+#include <cstddef>
+
+JUMBLE_NAMESPACE_BEGIN
+
+/*
+A bump allocator. Objects are placed one after another in large blocks
+and are never freed one by one. reset() makes all the memory available
+again in O(1) while keeping the blocks, so a reused arena stops calling
+the system allocator once it has grown to its peak size.
+
+Only trivially destructible objects can be created, since no destructor
+is run when the arena is reset.
+*/
+class Arena {
+public:
+    using SizeType = std::size_t;
+
+    static const SizeType DEFAULT_BLOCK_SIZE = 1 << 20;
+
+    /*
+    Initialize the arena. No memory is allocated until it is used.
+
+    @param blockSize_ The amount of bytes of each block
+    */
+    explicit Arena(const SizeType blockSize_ = DEFAULT_BLOCK_SIZE) noexcept
+        : blockSize(blockSize_), cur(0), offset(0), used(0) {}
+
+    // Forbid copy
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    // Move ctor
+    Arena(Arena&& other) noexcept
+        : blockSize(other.blockSize), cur(other.cur), offset(other.offset), used(other.used),
+          blocks(std::move(other.blocks)) {
+        other.release();
+    }
+
+    // Move assignment
+    Arena& operator=(Arena&& other) noexcept {
+        if (this != &other) {
+            blockSize = other.blockSize;
+            cur = other.cur;
+            offset = other.offset;
+            used = other.used;
+            blocks = std::move(other.blocks);
+            other.release();
+        }
+        return *this;
+    }
+
+    /*
+    Allocate uninitialized memory.
+
+    @param bytes The amount of bytes
+    @param align The alignment, no more than alignof(std::max_align_t)
+    @return      The address of the memory
+    */
+    void* allocate(const SizeType bytes, const SizeType align = alignof(std::max_align_t)) {
+        SizeType pos = (offset + align - 1) & ~(align - 1);
+        if (cur == blocks.size() || pos + bytes > blocks[cur].size) {
+            nextBlock(bytes);
+            pos = 0;
+        }
+        offset = pos + bytes;
+        used += bytes;
+        return blocks[cur].data.get() + pos;
+    }
+
+    // Create an object in the arena
+    template<typename T, typename... Args>
+    T* create(Args&&... args) {
+        static_assert(std::is_trivially_destructible<T>::value,
+                      "objects in an arena are never destroyed");
+        static_assert(alignof(T) <= alignof(std::max_align_t),
+                      "objects in an arena must not be over-aligned");
+        return new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+    }
+
+    /*
+    Free the memory of the last allocation. Memory of other
+    allocations is kept until the arena is reset.
+
+    @param p     The address returned by allocate()
+    @param bytes The amount of bytes passed to allocate()
+    */
+    void deallocate(void *const p, const SizeType bytes) noexcept {
+        if (cur < blocks.size() && static_cast<unsigned char*>(p) + bytes == blocks[cur].data.get() + offset) {
+            offset -= bytes;
+            used -= bytes;
+        }
+    }
+
+    // Make all memory available again. Objects in the arena become invalid.
+    void reset() noexcept {
+        cur = 0;
+        offset = 0;
+        used = 0;
+    }
+
+    // Reset the arena and return its blocks to the system
+    void release() noexcept {
+        blocks.clear();
+        reset();
+    }
+
+    // Return the amount of bytes allocated since the last reset
+    SizeType getUsedBytes() const noexcept {
+        return used;
+    }
+
+    // Return the amount of bytes held in blocks
+    SizeType getCapacity() const noexcept {
+        SizeType res = 0;
+        for (const auto &b : blocks) {
+            res += b.size;
+        }
+        return res;
+    }
+
+private:
+    struct Block {
+        std::unique_ptr<unsigned char[]> data;
+        SizeType size;
+    };
+
+    // Move to the next block with at least 'bytes' bytes
+    void nextBlock(const SizeType bytes) {
+        if (cur < blocks.size()) {
+            ++cur;
+        }
+        while (cur < blocks.size() && blocks[cur].size < bytes) {
+            ++cur;
+        }
+        if (cur == blocks.size()) {
+            SizeType size = std::max(blockSize, bytes);
+            blocks.push_back({std::unique_ptr<unsigned char[]>(new unsigned char[size]), size});
+        }
+        offset = 0;
+    }
+
+private:
+    SizeType blockSize;
+    SizeType cur;     // Index of the current block
+    SizeType offset;  // Offset of the free memory in the current block
+    SizeType used;
+
+    std::vector<Block> blocks;
+};
+
+JUMBLE_NAMESPACE_END
+
+#endif
@@ -0,0 +1,120 @@
+#ifndef JUMBLE_UTIL_BIT_OPS_HPP_INCLUDED
+#define JUMBLE_UTIL_BIT_OPS_HPP_INCLUDED
+
+#include "jumble/util/common.hpp"
+#include <cstddef>
+#include <cstdint>
+#ifdef JUMBLE_X86_SIMD
+#include <immintrin.h>
+#endif
+
+JUMBLE_NAMESPACE_BEGIN
+
+namespace detail {
+
+inline std::size_t popcountAndScalar(const std::uint64_t *const a, const std::uint64_t *const b,
+                                     const std::size_t n) noexcept {
+    std::size_t res = 0;
+    for (std::size_t i = 0; i < n; ++i) {
+        res += __builtin_popcountll(a[i] & b[i]);
+    }
+    return res;
+}
+
+#ifdef JUMBLE_X86_SIMD
+
+// Same as the scalar version, but compiled to the POPCNT instruction
+__attribute__((target("popcnt")))
+inline std::size_t popcountAndPOPCNT(const std::uint64_t *const a, const std::uint64_t *const b,
+                                     const std::size_t n) noexcept {
+    std::size_t res = 0;
+    for (std::size_t i = 0; i < n; ++i) {
+        res += __builtin_popcountll(a[i] & b[i]);
+    }
+    return res;
+}
+
+/*
+Count bits of 256-bit blocks by looking up the count of each nibble
+with a byte shuffle and summing the bytes with SAD.
+Reference: Mula et al., Faster Population Counts Using AVX2 Instructions.
+*/
+__attribute__((target("avx2,popcnt")))
+inline std::size_t popcountAndAVX2(const std::uint64_t *const a, const std::uint64_t *const b,
+                                   const std::size_t n) noexcept {
+    const __m256i lookup = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                            0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m256i lowMask = _mm256_set1_epi8(0x0f);
+    __m256i acc = _mm256_setzero_si256();
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256i v = _mm256_and_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i)),
+                                     _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i)));
+        __m256i lo = _mm256_and_si256(v, lowMask);
+        __m256i hi = _mm256_and_si256(_mm256_srli_epi16(v, 4), lowMask);
+        __m256i cnt = _mm256_add_epi8(_mm256_shuffle_epi8(lookup, lo),
+                                      _mm256_shuffle_epi8(lookup, hi));
+        acc = _mm256_add_epi64(acc, _mm256_sad_epu8(cnt, _mm256_setzero_si256()));
+    }
+    std::uint64_t lanes[4];
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(lanes), acc);
+    std::size_t res = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+    for (; i < n; ++i) {
+        res += __builtin_popcountll(a[i] & b[i]);
+    }
+    return res;
+}
+
+#endif
+
+using PopcountAndFunc = std::size_t (*)(const std::uint64_t*, const std::uint64_t*, std::size_t);
+
+// Select the fastest implementation supported by the running CPU
+inline PopcountAndFunc selectPopcountAnd() noexcept {
+#ifdef JUMBLE_X86_SIMD
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("popcnt")) {
+        return popcountAndAVX2;
+    }
+    if (__builtin_cpu_supports("popcnt")) {
+        return popcountAndPOPCNT;
+    }
+#endif
+    return popcountAndScalar;
+}
+
+}  // namespace detail
+
+/*
+Return the amount of set bits in the bitwise AND of two bit arrays.
+
+@param a The first bit array
+@param b The second bit array
+@param n The amount of 64-bit words in each array
+*/
+inline std::size_t popcountAnd(const std::uint64_t *const a, const std::uint64_t *const b,
+                               const std::size_t n) noexcept {
+    static const detail::PopcountAndFunc impl = detail::selectPopcountAnd();
+    return impl(a, b, n);
+}
+
+/*
+Visit the position of each set bit in a bit array in ascending order.
+
+@param bits The bit array
+@param n    The amount of 64-bit words in the array
+@param f    The function to visit each set bit. Params are:
+            @param i The position of the bit
+*/
+template<typename Func>
+void forEachSetBit(const std::uint64_t *const bits, const std::size_t n, Func f) {
+    for (std::size_t w = 0; w < n; ++w) {
+        for (std::uint64_t word = bits[w]; word; word &= word - 1) {
+            f(w * 64 + (std::size_t)__builtin_ctzll(word));
+        }
+    }
+}
+
+JUMBLE_NAMESPACE_END
+
+#endif
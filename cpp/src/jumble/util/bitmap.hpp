@@ -0,0 +1,66 @@
+#ifndef JUMBLE_UTIL_BITMAP_HPP_INCLUDED
+#define JUMBLE_UTIL_BITMAP_HPP_INCLUDED
+
+#include "jumble/util/common.hpp"
+#include <atomic>
+#include <memory>
+#include <utility>
+#include <cstddef>
+#include <cstdint>
+
+JUMBLE_NAMESPACE_BEGIN
+
+/*
+A fixed-size array of bits which can be set concurrently by many threads.
+*/
+class Bitmap {
+public:
+    using SizeType = std::size_t;
+    using Word = std::uint64_t;
+
+    static const SizeType WORD_BITS = 64;
+
+    // Initialize the bitmap with 'n' cleared bits
+    explicit Bitmap(const SizeType n)
+        : size(n), wordNum((n + WORD_BITS - 1) / WORD_BITS),
+          words(new std::atomic<Word>[wordNum]) {
+        clear();
+    }
+
+    // Return the amount of bits
+    SizeType getSize() const noexcept {
+        return size;
+    }
+
+    // Clear all bits
+    void clear() noexcept {
+        for (SizeType i = 0; i < wordNum; ++i) {
+            words[i].store(0, std::memory_order_relaxed);
+        }
+    }
+
+    // Return true if the i-th bit is set
+    bool get(const SizeType i) const noexcept {
+        return (words[i / WORD_BITS].load(std::memory_order_relaxed) >> (i % WORD_BITS)) & 1;
+    }
+
+    // Set the i-th bit (thread-safe)
+    void set(const SizeType i) noexcept {
+        words[i / WORD_BITS].fetch_or((Word)1 << (i % WORD_BITS), std::memory_order_relaxed);
+    }
+
+    void swap(Bitmap& other) noexcept {
+        std::swap(size, other.size);
+        std::swap(wordNum, other.wordNum);
+        std::swap(words, other.words);
+    }
+
+private:
+    SizeType size;
+    SizeType wordNum;
+    std::unique_ptr<std::atomic<Word>[]> words;
+};
+
+JUMBLE_NAMESPACE_END
+
+#endif
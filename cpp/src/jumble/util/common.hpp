@@ -6,4 +6,9 @@
 
 #define UNUSED(expr) (void)(expr)
 
+// Defined if x86 intrinsics can be enabled per function with target attributes
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define JUMBLE_X86_SIMD
+#endif
+
 #endif
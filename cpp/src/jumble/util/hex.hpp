@@ -0,0 +1,26 @@
+#ifndef JUMBLE_UTIL_HEX_HPP_INCLUDED
+#define JUMBLE_UTIL_HEX_HPP_INCLUDED
+
+#include "jumble/util/common.hpp"
+#include <cstddef>
+
+JUMBLE_NAMESPACE_BEGIN
+
+/*
+Encode bytes in lowercase hexadecimal.
+
+@param bytes The bytes
+@param n     The amount of bytes
+@param hex   The buffer to store the n * 2 characters, not null-terminated
+*/
+inline void toHex(const unsigned char *const bytes, const std::size_t n, char *const hex) noexcept {
+    static const char DIGITS[] = "0123456789abcdef";
+    for (std::size_t i = 0; i < n; ++i) {
+        hex[i * 2] = DIGITS[bytes[i] >> 4];
+        hex[i * 2 + 1] = DIGITS[bytes[i] & 0xf];
+    }
+}
+
+JUMBLE_NAMESPACE_END
+
+#endif
@@ -0,0 +1,106 @@
+#ifndef JUMBLE_UTIL_MAPPED_FILE_HPP_INCLUDED
+#define JUMBLE_UTIL_MAPPED_FILE_HPP_INCLUDED
+
+#include "jumble/util/common.hpp"
+#include <string>
+#include <stdexcept>
+#include <utility>
+#include <cstddef>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+JUMBLE_NAMESPACE_BEGIN
+
+/*
+A read-only memory mapping of a whole file (POSIX only).
+*/
+class MappedFile {
+public:
+    using SizeType = std::size_t;
+
+    /*
+    Map a file into memory.
+
+    @param path The path of the file
+    @throw std::runtime_error if the file cannot be opened or mapped
+    */
+    explicit MappedFile(const std::string& path) : addr(nullptr), size(0) {
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            throw std::runtime_error("cannot open " + path + ": " + std::strerror(errno));
+        }
+        struct stat st;
+        if (::fstat(fd, &st) != 0) {
+            int err = errno;
+            ::close(fd);
+            throw std::runtime_error("cannot stat " + path + ": " + std::strerror(err));
+        }
+        size = (SizeType)st.st_size;
+        if (size > 0) {
+            addr = ::mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+            if (addr == MAP_FAILED) {
+                int err = errno;
+                addr = nullptr;
+                ::close(fd);
+                throw std::runtime_error("cannot map " + path + ": " + std::strerror(err));
+            }
+        }
+        ::close(fd);  // The mapping stays valid after closing
+    }
+
+    // Forbid copy
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // Move ctor
+    MappedFile(MappedFile&& other) noexcept : addr(other.addr), size(other.size) {
+        other.addr = nullptr;
+        other.size = 0;
+    }
+
+    // Move assignment
+    MappedFile& operator=(MappedFile&& other) noexcept {
+        if (this != &other) {
+            unmap();
+            std::swap(addr, other.addr);
+            std::swap(size, other.size);
+        }
+        return *this;
+    }
+
+    // Dtor
+    ~MappedFile() noexcept {
+        unmap();
+    }
+
+    // Return the first byte of the file
+    const unsigned char* data() const noexcept {
+        return static_cast<const unsigned char*>(addr);
+    }
+
+    // Return the amount of bytes in the file
+    SizeType getSize() const noexcept {
+        return size;
+    }
+
+private:
+    void unmap() noexcept {
+        if (addr) {
+            ::munmap(addr, size);
+            addr = nullptr;
+            size = 0;
+        }
+    }
+
+private:
+    void *addr;
+    SizeType size;
+};
+
+JUMBLE_NAMESPACE_END
+
+#endif
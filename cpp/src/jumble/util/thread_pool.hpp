@@ -0,0 +1,232 @@
+#ifndef JUMBLE_UTIL_THREAD_POOL_HPP_INCLUDED
+#define JUMBLE_UTIL_THREAD_POOL_HPP_INCLUDED
+
+#include "jumble/util/common.hpp"
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <algorithm>
+#include <cstddef>
+
+JUMBLE_NAMESPACE_BEGIN
+
+/*
+A fixed amount of worker threads with work stealing. Each worker has its
+own task queue: tasks submitted by a worker go to the back of its queue
+and are run in LIFO order, tasks submitted from other threads are spread
+over the queues round-robin. An idle worker steals the oldest task from
+the front of another queue, so uneven tasks are balanced without all
+workers contending for one queue.
+*/
+class ThreadPool {
+public:
+    using SizeType = std::size_t;
+
+    /*
+    Initialize the pool and start the worker threads.
+
+    @param n The amount of worker threads (at least one thread is started)
+    */
+    explicit ThreadPool(const SizeType n = defaultSize())
+        : stop(false), pending(0), nextQueue(0), queues(std::max(n, (SizeType)1)) {
+        for (SizeType i = 0; i < queues.size(); ++i) {
+            workers.emplace_back([this, i] {
+                run(i);
+            });
+        }
+    }
+
+    // Forbid copy
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // Forbid move
+    ThreadPool(ThreadPool&&) = delete;
+    ThreadPool& operator=(ThreadPool&&) = delete;
+
+    // Finish the queued tasks and join all worker threads
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            stop = true;
+        }
+        cond.notify_all();
+        for (auto &w : workers) {
+            w.join();
+        }
+    }
+
+    // Return the amount of hardware threads, or one if it is unknown
+    static SizeType defaultSize() noexcept {
+        SizeType n = std::thread::hardware_concurrency();
+        return n ? n : 1;
+    }
+
+    // Return the amount of worker threads
+    SizeType getSize() const noexcept {
+        return workers.size();
+    }
+
+    /*
+    Return the index in [0, getSize()) of the calling worker thread,
+    or getSize() if it is not a worker thread of this pool. It can be
+    used to pick per-thread resources inside tasks.
+    */
+    SizeType getWorkerIndex() const noexcept {
+        const Worker &w = currentWorker();
+        return w.pool == this ? w.index : getSize();
+    }
+
+    /*
+    Queue a task to be run by one of the workers.
+
+    @param f The task with no params
+    @return  A future holding the result (or exception) of the task
+    */
+    template<typename Func>
+    auto submit(Func f) -> std::future<decltype(f())> {
+        using Result = decltype(f());
+        auto task = std::make_shared<std::packaged_task<Result()>>(std::move(f));
+        auto res = task->get_future();
+        SizeType q = getWorkerIndex();
+        {
+            // Count the task first, so 'pending' never drops below zero
+            std::lock_guard<std::mutex> lock(mtx);
+            ++pending;
+            if (q == getSize()) {
+                q = nextQueue++ % queues.size();
+            }
+        }
+        {
+            std::lock_guard<std::mutex> lock(queues[q].mtx);
+            queues[q].tasks.push_back([task] {
+                (*task)();
+            });
+        }
+        cond.notify_one();
+        return res;
+    }
+
+    /*
+    Split the interval [first, last) into chunks, run them on the
+    workers and wait until all of them finish. The first exception
+    thrown by a chunk is rethrown after all chunks are done.
+    Precondition: not called from a worker thread of the same pool.
+
+    @param first The first index of the interval
+    @param last  The index after the last one of the interval
+    @param f     The function to process one chunk. Params are:
+                 @param beg The first index of the chunk
+                 @param end The index after the last one of the chunk
+    */
+    template<typename Func>
+    void parallelFor(const SizeType first, const SizeType last, Func f) {
+        if (first >= last) {
+            return;
+        }
+        SizeType n = last - first;
+        SizeType chunks = std::min(n, workers.size() * CHUNKS_PER_WORKER);
+        SizeType step = (n + chunks - 1) / chunks;
+        std::vector<std::future<void>> futures;
+        for (SizeType beg = first; beg < last; beg += step) {
+            SizeType end = std::min(last, beg + step);
+            futures.push_back(submit([&f, beg, end] {
+                f(beg, end);
+            }));
+        }
+        for (auto &fut : futures) {
+            fut.wait();
+        }
+        for (auto &fut : futures) {
+            fut.get();
+        }
+    }
+
+private:
+    using Task = std::function<void()>;
+
+    // The task queue of one worker
+    struct Queue {
+        std::mutex mtx;
+        std::deque<Task> tasks;
+    };
+
+    // The pool and index of a worker thread
+    struct Worker {
+        const ThreadPool *pool;
+        SizeType index;
+    };
+
+    static Worker& currentWorker() noexcept {
+        static thread_local Worker w = {nullptr, 0};
+        return w;
+    }
+
+    // Pop a task from the back of its own queue, or steal one from the front of others
+    bool take(const SizeType index, Task& task) {
+        for (SizeType i = 0; i < queues.size(); ++i) {
+            Queue &q = queues[(index + i) % queues.size()];
+            std::lock_guard<std::mutex> lock(q.mtx);
+            if (!q.tasks.empty()) {
+                if (i == 0) {
+                    task = std::move(q.tasks.back());
+                    q.tasks.pop_back();
+                } else {
+                    task = std::move(q.tasks.front());
+                    q.tasks.pop_front();
+                }
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Worker loop: take and run tasks until the pool stops
+    void run(const SizeType index) {
+        currentWorker() = {this, index};
+        while (true) {
+            {
+                std::unique_lock<std::mutex> lock(mtx);
+                cond.wait(lock, [this] {
+                    return stop || pending > 0;
+                });
+                if (stop && pending == 0) {
+                    return;
+                }
+            }
+            Task task;
+            if (take(index, task)) {
+                {
+                    std::lock_guard<std::mutex> lock(mtx);
+                    --pending;
+                }
+                task();
+            } else {
+                // Counted tasks are being taken by other workers
+                std::this_thread::yield();
+            }
+        }
+    }
+
+private:
+    // More chunks than workers to balance uneven chunks
+    static const SizeType CHUNKS_PER_WORKER = 4;
+
+    bool stop;
+    SizeType pending;  // Amount of queued tasks, guarded by 'mtx'
+    SizeType nextQueue;
+    std::mutex mtx;
+    std::condition_variable cond;
+
+    std::vector<Queue> queues;
+    std::vector<std::thread> workers;
+};
+
+JUMBLE_NAMESPACE_END
+
+#endif
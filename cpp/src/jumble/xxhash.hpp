@@ -0,0 +1,287 @@
+#ifndef JUMBLE_XXHASH_HPP_INCLUDED
+#define JUMBLE_XXHASH_HPP_INCLUDED
+
+#include "jumble/util/common.hpp"
+#include "jumble/util/hex.hpp"
+#include <string>
+#include <functional>
+#include <cstring>
+#include <cstddef>
+#include <cstdint>
+
+JUMBLE_NAMESPACE_BEGIN
+
+/*
+The 64-bit xxHash (XXH64), a fast non-cryptographic hash. The input is
+consumed in stripes of 32 bytes by four independent accumulators, so
+the multiplications of one stripe run in parallel.
+Reference: Yann Collet, xxHash fast digest algorithm, XXH64 specification.
+*/
+class XXH64 {
+public:
+    using UInt64 = std::uint64_t;
+    using SizeType = std::size_t;
+
+    XXH64() = delete;
+
+    static const UInt64 PRIME1 = 0x9e3779b185ebca87ULL;
+    static const UInt64 PRIME2 = 0xc2b2ae3d27d4eb4fULL;
+    static const UInt64 PRIME3 = 0x165667b19e3779f9ULL;
+    static const UInt64 PRIME4 = 0x85ebca77c2b2ae63ULL;
+    static const UInt64 PRIME5 = 0x27d4eb2f165667c5ULL;
+
+    /*
+    Hash a message.
+
+    @param data The message to be hashed
+    @param len  The length of the message in bytes
+    @param seed The seed
+    @return     The hash value
+    */
+    static UInt64 hash(const void *const data, const SizeType len, const UInt64 seed = 0) noexcept {
+        const unsigned char *p = static_cast<const unsigned char*>(data);
+        UInt64 h;
+        if (len >= 32) {
+            UInt64 v[4];
+            initAcc(v, seed);
+            processStripes(v, p, len / 32);
+            h = mergeAcc(v);
+        } else {
+            h = seed + PRIME5;
+        }
+        return finish(h, p + len / 32 * 32, len % 32, len);
+    }
+
+    // Scramble the bits of a 64-bit value, the last step of the hash
+    static UInt64 avalanche(UInt64 h) noexcept {
+        h ^= h >> 33;
+        h *= PRIME2;
+        h ^= h >> 29;
+        h *= PRIME3;
+        h ^= h >> 32;
+        return h;
+    }
+
+private:
+    friend class XXH64Context;
+
+    static UInt64 rotate(const UInt64 x, const int n) noexcept {
+        return (x << n) | (x >> (64 - n));
+    }
+
+    // Read a little-endian 64-bit integer
+    static UInt64 read64(const unsigned char *const p) noexcept {
+        UInt64 res;
+        std::memcpy(&res, p, sizeof(res));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+        res = __builtin_bswap64(res);
+#endif
+        return res;
+    }
+
+    // Read a little-endian 32-bit integer
+    static UInt64 read32(const unsigned char *const p) noexcept {
+        std::uint32_t res;
+        std::memcpy(&res, p, sizeof(res));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+        res = __builtin_bswap32(res);
+#endif
+        return res;
+    }
+
+    static UInt64 round(UInt64 acc, const UInt64 input) noexcept {
+        acc += input * PRIME2;
+        return rotate(acc, 31) * PRIME1;
+    }
+
+    static void initAcc(UInt64 (&v)[4], const UInt64 seed) noexcept {
+        v[0] = seed + PRIME1 + PRIME2;
+        v[1] = seed + PRIME2;
+        v[2] = seed;
+        v[3] = seed - PRIME1;
+    }
+
+    static void processStripes(UInt64 (&v)[4], const unsigned char *p, SizeType stripes) noexcept {
+        UInt64 v0 = v[0], v1 = v[1], v2 = v[2], v3 = v[3];
+        for (; stripes; --stripes, p += 32) {
+            v0 = round(v0, read64(p));
+            v1 = round(v1, read64(p + 8));
+            v2 = round(v2, read64(p + 16));
+            v3 = round(v3, read64(p + 24));
+        }
+        v[0] = v0;
+        v[1] = v1;
+        v[2] = v2;
+        v[3] = v3;
+    }
+
+    static UInt64 mergeAcc(const UInt64 (&v)[4]) noexcept {
+        UInt64 h = rotate(v[0], 1) + rotate(v[1], 7) + rotate(v[2], 12) + rotate(v[3], 18);
+        for (int i = 0; i < 4; ++i) {
+            h ^= round(0, v[i]);
+            h = h * PRIME1 + PRIME4;
+        }
+        return h;
+    }
+
+    // Mix in the total length and the last bytes of less than a stripe
+    static UInt64 finish(UInt64 h, const unsigned char *p, SizeType rest, const UInt64 len) noexcept {
+        h += len;
+        for (; rest >= 8; rest -= 8, p += 8) {
+            h ^= round(0, read64(p));
+            h = rotate(h, 27) * PRIME1 + PRIME4;
+        }
+        if (rest >= 4) {
+            h ^= read32(p) * PRIME1;
+            h = rotate(h, 23) * PRIME2 + PRIME3;
+            rest -= 4;
+            p += 4;
+        }
+        for (; rest; --rest, ++p) {
+            h ^= *p * PRIME5;
+            h = rotate(h, 11) * PRIME1;
+        }
+        return avalanche(h);
+    }
+};
+
+/*
+An incremental XXH64 computation, with the same interface as
+MD5Context. The digest is the big-endian hash value, as printed by
+xxhsum, and getValue() returns the hash value itself.
+*/
+class XXH64Context {
+public:
+    using UInt64 = std::uint64_t;
+    using SizeType = std::size_t;
+
+    static const SizeType BLOCK_SIZE = 32;
+    static const SizeType DIGEST_SIZE = 8;
+
+    explicit XXH64Context(const UInt64 seed_ = 0) noexcept {
+        reset(seed_);
+    }
+
+    /*
+    Start a new message.
+
+    @param seed_ The seed
+    */
+    void reset(const UInt64 seed_) noexcept {
+        seed = seed_;
+        reset();
+    }
+
+    // Start a new message with the same seed
+    void reset() noexcept {
+        XXH64::initAcc(acc, seed);
+        total = 0;
+        used = 0;
+    }
+
+    /*
+    Append data to the message.
+
+    @param data The data
+    @param len  The amount of bytes
+    */
+    void update(const void *const data, SizeType len) noexcept {
+        const unsigned char *p = static_cast<const unsigned char*>(data);
+        total += len;
+        if (used) {
+            SizeType n = BLOCK_SIZE - used < len ? BLOCK_SIZE - used : len;
+            std::memcpy(buffer + used, p, n);
+            used += n;
+            p += n;
+            len -= n;
+            if (used < BLOCK_SIZE) {
+                return;
+            }
+            XXH64::processStripes(acc, buffer, 1);
+            used = 0;
+        }
+        if (len >= BLOCK_SIZE) {
+            XXH64::processStripes(acc, p, len / BLOCK_SIZE);
+            p += len / BLOCK_SIZE * BLOCK_SIZE;
+            len %= BLOCK_SIZE;
+        }
+        if (len) {
+            std::memcpy(buffer, p, len);
+            used = len;
+        }
+    }
+
+    // Return the hash value of the data appended so far
+    UInt64 getValue() const noexcept {
+        UInt64 h = total >= BLOCK_SIZE ? XXH64::mergeAcc(acc) : seed + XXH64::PRIME5;
+        return XXH64::finish(h, buffer, used, total);
+    }
+
+    /*
+    Finish the message and start a new one.
+
+    @param digest The buffer to store the DIGEST_SIZE bytes of the digest
+    */
+    void finalize(unsigned char *const digest) noexcept {
+        UInt64 h = getValue();
+        for (SizeType i = 0; i < DIGEST_SIZE; ++i) {
+            digest[i] = (unsigned char)(h >> ((DIGEST_SIZE - 1 - i) * 8));
+        }
+        reset();
+    }
+
+    /*
+    Finish the message and start a new one.
+
+    @return The hashed string result
+    */
+    std::string finalize() {
+        unsigned char digest[DIGEST_SIZE];
+        finalize(digest);
+        return toHex(digest);
+    }
+
+    /*
+    Encode a digest in lowercase hexadecimal.
+
+    @param digest The DIGEST_SIZE bytes of the digest
+    @return       The hexadecimal string
+    */
+    static std::string toHex(const unsigned char *const digest) {
+        std::string res(DIGEST_SIZE * 2, '0');
+        jumble::toHex(digest, DIGEST_SIZE, &res[0]);
+        return res;
+    }
+
+private:
+    UInt64 seed;
+    UInt64 acc[4];   // The accumulators of the stripes
+    UInt64 total;    // Length of the message in bytes
+    SizeType used;   // Bytes in the buffer
+    unsigned char buffer[BLOCK_SIZE];  // The partial stripe
+};
+
+/*
+The recommended hash functor of HashTable and AStar. std::hash of
+integers and pointers is the identity in common libraries, so keys
+that differ only in their high bits, such as multiples of a power of
+two, would share buckets of a power-of-two table. FastHash scrambles
+such values with the XXH64 avalanche, and hashes strings with XXH64.
+*/
+template<typename T>
+struct FastHash {
+    std::size_t operator()(const T& val) const {
+        return (std::size_t)XXH64::avalanche((std::uint64_t)std::hash<T>()(val));
+    }
+};
+
+template<>
+struct FastHash<std::string> {
+    std::size_t operator()(const std::string& str) const noexcept {
+        return (std::size_t)XXH64::hash(str.data(), str.size());
+    }
+};
+
+JUMBLE_NAMESPACE_END
+
+#endif
@@ -0,0 +1,163 @@
+#include "catch2/catch_amalgamated.hpp"
+#include "jumble/astar.hpp"
+#include "jumble/util/random.hpp"
+#include <vector>
+#include <queue>
+#include <utility>
+#include <functional>
+#include <limits>
+#include <cstddef>
+#include <cstdint>
+
+using jumble::AStar;
+
+typedef std::uint32_t Cost;
+typedef std::vector<std::vector<std::pair<int, Cost>>> Edges;
+
+// The outgoing edges of a vertex
+struct Expand {
+    const Edges *edges;
+
+    template<typename Emit>
+    void operator()(const int v, Emit&& emit) const {
+        for (const auto &e : (*edges)[v]) {
+            emit(e.first, e.second);
+        }
+    }
+};
+
+// A heuristic of given values
+struct Table {
+    std::vector<Cost> h;
+
+    Cost operator()(const int v) const {
+        return h.empty() ? 0 : h[v];
+    }
+};
+
+// Return the shortest distances from a vertex by Dijkstra's algorithm
+static std::vector<Cost> shortest(const Edges& edges, const int from) {
+    std::vector<Cost> dist(edges.size(), std::numeric_limits<Cost>::max());
+    typedef std::pair<Cost, int> Item;
+    std::priority_queue<Item, std::vector<Item>, std::greater<Item>> queue;
+    dist[from] = 0;
+    queue.push({0, from});
+    while (!queue.empty()) {
+        Item cur = queue.top();
+        queue.pop();
+        if (cur.first != dist[cur.second]) {
+            continue;
+        }
+        for (const auto &e : edges[cur.second]) {
+            if (cur.first + e.second < dist[e.first]) {
+                dist[e.first] = cur.first + e.second;
+                queue.push({dist[e.first], e.first});
+            }
+        }
+    }
+    return dist;
+}
+
+// Check the costs of paths from vertex 0 to every vertex of a random graph
+template<template<typename> class OpenList, template<typename> class Allocator>
+static void checkRandomGraph() {
+    jumble::Random *random = jumble::Random::getInstance();
+    const int n = 200;
+    Edges edges(n);
+    for (int i = 0; i < n * 4; ++i) {
+        edges[random->nextInt(0, n - 1)].push_back({random->nextInt(0, n - 1), (Cost)random->nextInt(1, 10)});
+    }
+    std::vector<Cost> dist = shortest(edges, 0);
+
+    AStar<int, Expand, Table, std::hash<int>, std::equal_to<int>, OpenList,
+          jumble::HashClosedSet, Allocator> search(Expand{&edges});
+    for (int v = 0; v < n; ++v) {
+        bool found = search.search(0, v);
+        REQUIRE(found == (dist[v] != std::numeric_limits<Cost>::max()));
+        if (!found) {
+            REQUIRE(search.getPath().empty());
+            continue;
+        }
+        REQUIRE(search.getCost() == dist[v]);
+        std::vector<int> path = search.getPath();
+        REQUIRE(path.front() == 0);
+        REQUIRE(path.back() == v);
+        Cost cost = 0;
+        for (std::size_t i = 1; i < path.size(); ++i) {
+            Cost best = std::numeric_limits<Cost>::max();
+            for (const auto &e : edges[path[i - 1]]) {
+                if (e.first == path[i] && e.second < best) {
+                    best = e.second;
+                }
+            }
+            REQUIRE(best != std::numeric_limits<Cost>::max());
+            cost += best;
+        }
+        REQUIRE(cost == dist[v]);
+    }
+}
+
+TEST_CASE("Policies") {
+    checkRandomGraph<jumble::HeapOpenList, jumble::ArenaAllocator>();
+    checkRandomGraph<jumble::HeapOpenList, jumble::SystemAllocator>();
+    checkRandomGraph<jumble::BucketOpenList, jumble::ArenaAllocator>();
+    checkRandomGraph<jumble::BucketOpenList, jumble::SystemAllocator>();
+}
+
+TEST_CASE("Reopen") {
+    // The heuristic is admissible but not consistent, so vertex 2 is
+    // expanded through the edge 0->2 before the shorter path 0->1->2
+    // is known, and has to be expanded again.
+    Edges edges = {{{1, 1}, {2, 3}}, {{2, 1}}, {{3, 5}}, {}};
+    AStar<int, Expand, Table> search(Expand{&edges}, Table{{0, 6, 0, 0}});
+    REQUIRE(search.search(0, 3));
+    REQUIRE(search.getCost() == (Cost)7);
+    REQUIRE(search.getPath() == std::vector<int>({0, 1, 2, 3}));
+
+    const auto &stats = search.getStats();
+    REQUIRE(stats.expansions == (std::size_t)5);
+    REQUIRE(stats.generations == (std::size_t)5);
+    REQUIRE(stats.duplicates == (std::size_t)0);
+    REQUIRE(stats.peakBytes > (std::size_t)0);
+}
+
+TEST_CASE("Counters") {
+    // A 3*3 grid of vertices with edges to the right and down
+    Edges edges(9);
+    for (int v = 0; v < 9; ++v) {
+        if (v % 3 != 2) {
+            edges[v].push_back({v + 1, 1});
+        }
+        if (v < 6) {
+            edges[v].push_back({v + 3, 1});
+        }
+    }
+    AStar<int, Expand, Table> search(Expand{&edges});
+    REQUIRE(search.search(0, 8));
+    REQUIRE(search.getCost() == (Cost)4);
+    const auto &stats = search.getStats();
+    REQUIRE(stats.expansions == (std::size_t)9);
+    REQUIRE(stats.generations == (std::size_t)12);
+    REQUIRE(stats.duplicates == (std::size_t)4);  // Vertices reached from both the left and above
+
+    search.clear();
+    REQUIRE(search.getGoal() == nullptr);
+    REQUIRE(search.getStats().expansions == (std::size_t)0);
+}
+
+TEST_CASE("GoalPredicate") {
+    // An infinite graph: from n to n + 1 and to 2n
+    auto expand = [](const int n, auto&& emit) {
+        emit(n + 1, 1);
+        emit(n * 2, 1);
+    };
+    auto zero = [](const int) {
+        return (Cost)0;
+    };
+    AStar<int, decltype(expand), decltype(zero)> search(expand, zero);
+    REQUIRE(search.search(1, [](const int n) {
+        return n >= 100;
+    }));
+    REQUIRE(search.getCost() == (Cost)7);  // 1, 2, 4, ..., 128
+    REQUIRE(search.getPath().back() >= 100);
+}
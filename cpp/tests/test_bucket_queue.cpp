@@ -0,0 +1,78 @@
+#include "catch2/catch_amalgamated.hpp"
+#include "jumble/bucket_queue.hpp"
+#include "jumble/util/random.hpp"
+#include <vector>
+#include <tuple>
+#include <algorithm>
+
+typedef jumble::BucketQueue<int>::SizeType SizeType;
+
+TEST_CASE("Basic") {
+    jumble::BucketQueue<int> queue;
+    REQUIRE(queue.isEmpty());
+    REQUIRE(queue.getSize() == (SizeType)0);
+
+    queue.push(50, 5);
+    queue.push(20, 2);
+    queue.push(30, 3);
+    REQUIRE(!queue.isEmpty());
+    REQUIRE(queue.getSize() == (SizeType)3);
+    REQUIRE(queue.top() == 20);
+
+    queue.pop();
+    REQUIRE(queue.top() == 30);
+    queue.push(10, 1);
+    REQUIRE(queue.top() == 10);
+    queue.pop();
+
+    queue.pop();
+    REQUIRE(queue.top() == 50);
+    REQUIRE(queue.getSize() == (SizeType)1);
+
+    queue.pop();
+    REQUIRE(queue.isEmpty());
+    REQUIRE(queue.getSize() == (SizeType)0);
+}
+
+TEST_CASE("TieBreaking") {
+    jumble::BucketQueue<int> queue;
+    queue.push(1, 4, 2);
+    queue.push(2, 4, 0);
+    queue.push(3, 4, 2);
+    queue.push(4, 4, 0);
+    queue.push(5, 3, 9);
+    std::vector<int> order;
+    while (!queue.isEmpty()) {
+        order.push_back(queue.top());
+        queue.pop();
+    }
+    // Smaller secondary keys first, then LIFO
+    REQUIRE(order == std::vector<int>({5, 4, 2, 3, 1}));
+}
+
+TEST_CASE("Random") {
+    typedef std::tuple<SizeType, SizeType, int> Entry;
+    jumble::Random *random = jumble::Random::getInstance();
+    jumble::BucketQueue<int> queue;
+    for (int round = 0; round < 2; ++round) {
+        std::vector<Entry> entries;
+        for (int i = 0; i < 2000; ++i) {
+            SizeType key1 = random->nextInt(0, 50), key2 = random->nextInt(0, 20);
+            entries.emplace_back(key1, key2, i);
+            queue.push(i, key1, key2);
+            if (i % 3 == 0) {
+                // Pop the smallest keys, the latest one among equal keys
+                auto it = std::min_element(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) {
+                    return std::make_tuple(std::get<0>(a), std::get<1>(a), -std::get<2>(a))
+                         < std::make_tuple(std::get<0>(b), std::get<1>(b), -std::get<2>(b));
+                });
+                REQUIRE(queue.top() == std::get<2>(*it));
+                queue.pop();
+                entries.erase(it);
+            }
+        }
+        REQUIRE(queue.getSize() == entries.size());
+        queue.clear();
+        REQUIRE(queue.isEmpty());
+    }
+}
@@ -1,5 +1,10 @@
 #include "catch2/catch_amalgamated.hpp"
 #include "jumble/calculator.hpp"
+#include <sstream>
+#include <string>
+#include <vector>
+#include <stdexcept>
+#include <cstdint>
 
 using jumble::Token;
 using jumble::Lexer;
@@ -10,13 +15,13 @@ TEST_CASE("Lexer1") {
     std::istringstream iss(" (-10) + +23");
 
     std::vector<Token> actual_toks = {
-        Token::oper("("),
-        Token::oper("-"),
-        Token::num("10"),
-        Token::oper(")"),
-        Token::oper("+"),
-        Token::oper("+"),
-        Token::num("23"),
+        Token::oper(Token::LEFT),
+        Token::oper(Token::SUB),
+        Token::num(10),
+        Token::oper(Token::RIGHT),
+        Token::oper(Token::ADD),
+        Token::oper(Token::ADD),
+        Token::num(23),
     };
 
     Lexer lexer(iss);
@@ -36,14 +41,14 @@ TEST_CASE("Lexer2") {
     std::istringstream iss(" \n4* -\v(567/8)");
 
     std::vector<Token> actual_toks = {
-        Token::num("4"),
-        Token::oper("*"),
-        Token::oper("-"),
-        Token::oper("("),
-        Token::num("567"),
-        Token::oper("/"),
-        Token::num("8"),
-        Token::oper(")"),
+        Token::num(4),
+        Token::oper(Token::MUL),
+        Token::oper(Token::SUB),
+        Token::oper(Token::LEFT),
+        Token::num(567),
+        Token::oper(Token::DIV),
+        Token::num(8),
+        Token::oper(Token::RIGHT),
     };
 
     Lexer lexer(iss);
@@ -63,18 +68,18 @@ TEST_CASE("Lexer3") {
     std::istringstream iss("90*(- 345/ (1+2))\n");
  
     std::vector<Token> actual_toks = {
-        Token::num("90"),
-        Token::oper("*"),
-        Token::oper("("),
-        Token::oper("-"),
-        Token::num("345"),
-        Token::oper("/"),
-        Token::oper("("),
-        Token::num("1"),
-        Token::oper("+"),
-        Token::num("2"),
-        Token::oper(")"),
-        Token::oper(")"),
+        Token::num(90),
+        Token::oper(Token::MUL),
+        Token::oper(Token::LEFT),
+        Token::oper(Token::SUB),
+        Token::num(345),
+        Token::oper(Token::DIV),
+        Token::oper(Token::LEFT),
+        Token::num(1),
+        Token::oper(Token::ADD),
+        Token::num(2),
+        Token::oper(Token::RIGHT),
+        Token::oper(Token::RIGHT),
     };
 
     Lexer lexer(iss);
@@ -94,18 +99,18 @@ TEST_CASE("Parser1") {
     std::istringstream iss("+ 3 *( -1+(-(1 -2)) ) /  2");
 
     std::vector<Token> actual_toks = {
-        Token::num("3"),
-        Token::oper("@"),
-        Token::num("1"),
-        Token::oper("#"),
-        Token::num("1"),
-        Token::num("2"),
-        Token::oper("-"),
-        Token::oper("#"),
-        Token::oper("+"),
-        Token::oper("*"),
-        Token::num("2"),
-        Token::oper("/"),
+        Token::num(3),
+        Token::oper(Token::POS),
+        Token::num(1),
+        Token::oper(Token::NEG),
+        Token::num(1),
+        Token::num(2),
+        Token::oper(Token::SUB),
+        Token::oper(Token::NEG),
+        Token::oper(Token::ADD),
+        Token::oper(Token::MUL),
+        Token::num(2),
+        Token::oper(Token::DIV),
     };
 
     Parser parser(iss);
@@ -117,22 +122,22 @@ TEST_CASE("Parser2") {
     std::istringstream iss("(-3) *(- 20+(-(2*(3+5))- (8+7)) )");
 
     std::vector<Token> actual_toks = {
-        Token::num("3"),
-        Token::oper("#"),
-        Token::num("20"),
-        Token::oper("#"),
-        Token::num("2"),
-        Token::num("3"),
-        Token::num("5"),
-        Token::oper("+"),
-        Token::oper("*"),
-        Token::oper("#"),
-        Token::num("8"),
-        Token::num("7"),
-        Token::oper("+"),
-        Token::oper("-"),
-        Token::oper("+"),
-        Token::oper("*"),
+        Token::num(3),
+        Token::oper(Token::NEG),
+        Token::num(20),
+        Token::oper(Token::NEG),
+        Token::num(2),
+        Token::num(3),
+        Token::num(5),
+        Token::oper(Token::ADD),
+        Token::oper(Token::MUL),
+        Token::oper(Token::NEG),
+        Token::num(8),
+        Token::num(7),
+        Token::oper(Token::ADD),
+        Token::oper(Token::SUB),
+        Token::oper(Token::ADD),
+        Token::oper(Token::MUL),
     };
 
     Parser parser(iss);
@@ -262,3 +267,159 @@ TEST_CASE("Calculate") {
     iss.clear();
     REQUIRE(Calculator(iss).calculate() == 40);
 }
+
+TEST_CASE("Tokens") {
+    REQUIRE(Token::num(42).number() == 42);
+    REQUIRE(Token::num(42).str() == "42");
+    REQUIRE(Token::oper(Token::DIV).op() == Token::DIV);
+    REQUIRE(Token::oper(Token::DIV).str() == "/");
+    REQUIRE(Token::end().str() == "$");
+    REQUIRE(Token::num(1) != Token::num(2));
+    REQUIRE(Token::oper(Token::ADD) != Token::oper(Token::SUB));
+
+    // Unknown characters are operators rejected by the parser
+    std::istringstream iss("1 ?");
+    Lexer lexer(iss);
+    REQUIRE(lexer.scan() == Token::num(1));
+    REQUIRE(lexer.scan() == Token::oper(Token::Op('?')));
+
+    // The largest 64-bit integer, and one more
+    iss.str("9223372036854775807 9223372036854775808");
+    iss.clear();
+    lexer.reset();
+    REQUIRE(lexer.scan() == Token::num(INT64_MAX));
+    REQUIRE_THROWS_AS(lexer.scan(), std::runtime_error);
+}
+
+TEST_CASE("Reuse") {
+    // One calculator for many expressions of a refilled stream
+    std::istringstream iss;
+    Calculator calc(iss);
+    const char *exprs[] = {"1+2*3", "(1+2)*3", "-7/2", "3000000000*3000000000"};
+    const std::int64_t expect[] = {7, 9, -3, 9000000000000000000LL};
+    for (int r = 0; r < 3; ++r) {
+        for (int i = 0; i < 4; ++i) {
+            iss.str(exprs[i]);
+            iss.clear();
+            REQUIRE(calc.calculate() == expect[i]);
+        }
+    }
+}
+
+TEST_CASE("Overflow") {
+    // The range of std::int64_t is [-9223372036854775807 - 1, 9223372036854775807]
+    const char *good[] = {"9223372036854775806+1", "-9223372036854775807-1",
+                          "(-9223372036854775807-1)/1", "-(-9223372036854775807)",
+                          "3037000499*3037000499"};
+    const std::int64_t expect[] = {INT64_MAX, INT64_MIN, INT64_MIN, INT64_MAX,
+                                   9223372030926249001LL};
+    for (int i = 0; i < 5; ++i) {
+        std::istringstream iss(good[i]);
+        REQUIRE(Calculator(iss).calculate() == expect[i]);
+    }
+    for (auto str : {"9223372036854775807+1", "-9223372036854775807-2",
+                     "0-(-9223372036854775807-1)", "-(-9223372036854775807-1)",
+                     "(-9223372036854775807-1)/-1",
+                     "3037000500*3037000500", "-4611686018427387905*2"}) {
+        std::istringstream iss(str);
+        REQUIRE_THROWS_WITH(Calculator(iss).calculate(), "overflow");
+    }
+}
+
+TEST_CASE("Variables") {
+    std::istringstream iss("x1 *(_y- x1)/ y_2");
+    Lexer lexer(iss);
+    std::vector<Token> expect_toks = {
+        Token::var(0),
+        Token::oper(Token::MUL),
+        Token::oper(Token::LEFT),
+        Token::var(1),
+        Token::oper(Token::SUB),
+        Token::var(0),
+        Token::oper(Token::RIGHT),
+        Token::oper(Token::DIV),
+        Token::var(2),
+    };
+    std::vector<Token> actual_toks;
+    for (auto tok = lexer.scan(); tok.type() != Token::END_INPUT; tok = lexer.scan()) {
+        actual_toks.push_back(tok);
+    }
+    REQUIRE(actual_toks == expect_toks);
+    REQUIRE(lexer.getNames() == std::vector<std::string>{"x1", "_y", "y_2"});
+
+    iss.str("a b");
+    iss.clear();
+    std::string what;
+    try {
+        Parser(iss).parse();
+    } catch (std::runtime_error &e) {
+        what = e.what();
+    }
+    REQUIRE(what == "tmpB meets variable b");
+
+    iss.str("2 * rate");
+    iss.clear();
+    what = "";
+    try {
+        Calculator(iss).calculate();
+    } catch (std::runtime_error &e) {
+        what = e.what();
+    }
+    REQUIRE(what == "unbound variable rate");
+
+    iss.str("1 / (2 - 2)");
+    iss.clear();
+    REQUIRE_THROWS_AS(Calculator(iss).calculate(), std::runtime_error);
+}
+
+TEST_CASE("Compile") {
+    std::istringstream iss("( 60 /(2*(3+4)+(5- 2)/ 3)-1-1) * 8-(20/4+(3-5) *20+3+ (- 4) +88/8-(2-3))");
+    jumble::CompiledExpr constant = Parser(iss).compile();
+    REQUIRE(constant.getVariables().empty());
+    REQUIRE(constant.eval(std::vector<std::int64_t>()) == 40);
+
+    iss.str("+price * (100 - discount) / 100 - -fee");
+    iss.clear();
+    jumble::CompiledExpr expr = Parser(iss).compile();
+    REQUIRE(expr.getVariables() == std::vector<std::string>{"price", "discount", "fee"});
+    REQUIRE(expr.getIndex("fee") == (std::size_t)2);
+    REQUIRE_THROWS_AS(expr.getIndex("tax"), std::invalid_argument);
+
+    // Compare with calculating the expression with the values substituted
+    std::int64_t values[3];
+    for (values[0] = 0; values[0] < 500; values[0] += 37) {
+        for (values[1] = -10; values[1] <= 100; values[1] += 11) {
+            for (values[2] = -3; values[2] <= 3; values[2] += 3) {
+                std::istringstream sub("+(" + std::to_string(values[0]) + ") * (100 - ("
+                                       + std::to_string(values[1]) + ")) / 100 - -("
+                                       + std::to_string(values[2]) + ")");
+                REQUIRE(expr.eval(values) == Calculator(sub).calculate());
+            }
+        }
+    }
+    REQUIRE(expr.eval({250, 20, 5}) == 205);
+    REQUIRE_THROWS_AS(expr.eval({1, 2}), std::invalid_argument);
+
+    iss.str("a / (b - c)");
+    iss.clear();
+    jumble::CompiledExpr div = Parser(iss).compile();
+    REQUIRE(div.eval({7, 5, 3}) == 3);
+    REQUIRE_THROWS_AS(div.eval({7, 3, 3}), std::runtime_error);
+    REQUIRE(div.eval({INT64_MIN, -1, -2}) == INT64_MIN);
+    REQUIRE_THROWS_WITH(div.eval({INT64_MIN, -1, 0}), "overflow");
+
+    // Overflow of the other operators
+    iss.str("-a * b + c");
+    iss.clear();
+    jumble::CompiledExpr mix = Parser(iss).compile();
+    REQUIRE(mix.eval({INT64_MAX, 1, 0}) == -INT64_MAX);
+    REQUIRE(mix.eval({-INT64_MAX, 1, -1}) == INT64_MAX - 1);
+    REQUIRE_THROWS_WITH(mix.eval({INT64_MIN, 1, 0}), "overflow");
+    REQUIRE_THROWS_WITH(mix.eval({3037000500, 3037000500, 0}), "overflow");
+    REQUIRE_THROWS_WITH(mix.eval({-INT64_MAX, 1, 1}), "overflow");
+    REQUIRE_THROWS_WITH(mix.eval({INT64_MAX, 1, -2}), "overflow");
+
+    iss.str("(x");
+    iss.clear();
+    REQUIRE_THROWS_AS(Parser(iss).compile(), std::runtime_error);
+}
@@ -0,0 +1,69 @@
+#include "catch2/catch_amalgamated.hpp"
+#include "jumble/csr_graph.hpp"
+#include <stdexcept>
+
+using jumble::CSRGraph;
+
+typedef jumble::Graph<int> G;
+typedef CSRGraph::NumType NumType;
+typedef CSRGraph::WeightType WeightType;
+
+TEST_CASE("Empty") {
+    CSRGraph graph;
+    REQUIRE(graph.getSize() == (NumType)0);
+    REQUIRE(graph.getEdgeCount() == (NumType)0);
+    REQUIRE(graph.transpose().getSize() == (NumType)0);
+}
+
+TEST_CASE("FromGraph") {
+    for (auto type : {G::LIST, G::MATRIX}) {
+        G src(4, type);
+        src.setWeight(0, 1, 10);
+        src.setWeight(0, 3, 20);
+        src.setWeight(2, 1, 30);
+        src.setWeight(3, 0, 40);
+        src.setWeight(3, 2, G::MAX_WEIGHT);  // Not an edge
+
+        CSRGraph graph(src);
+        REQUIRE(graph.getSize() == (NumType)4);
+        REQUIRE(graph.getEdgeCount() == (NumType)4);
+        REQUIRE(graph.getDegree(0) == (NumType)2);
+        REQUIRE(graph.getDegree(1) == (NumType)0);
+        REQUIRE(graph.getDegree(2) == (NumType)1);
+        REQUIRE(graph.getDegree(3) == (NumType)1);
+        REQUIRE(graph.neighborBegin(0)[0] == (NumType)1);
+        REQUIRE(graph.neighborBegin(0)[1] == (NumType)3);
+        REQUIRE(graph.weightBegin(0)[0] == (WeightType)10);
+        REQUIRE(graph.weightBegin(0)[1] == (WeightType)20);
+        REQUIRE(graph.neighborBegin(2)[0] == (NumType)1);
+        REQUIRE(graph.weightBegin(2)[0] == (WeightType)30);
+        REQUIRE(graph.neighborBegin(3)[0] == (NumType)0);
+        REQUIRE(graph.weightBegin(3)[0] == (WeightType)40);
+        REQUIRE(graph.neighborBegin(1) == graph.neighborEnd(1));
+    }
+}
+
+TEST_CASE("Transpose") {
+    CSRGraph graph({0, 2, 2, 3, 4}, {1, 3, 1, 0}, {10, 20, 30, 40});
+    CSRGraph trans = graph.transpose();
+    REQUIRE(trans.getSize() == (NumType)4);
+    REQUIRE(trans.getEdgeCount() == (NumType)4);
+    REQUIRE(trans.getDegree(0) == (NumType)1);
+    REQUIRE(trans.getDegree(1) == (NumType)2);
+    REQUIRE(trans.getDegree(2) == (NumType)0);
+    REQUIRE(trans.getDegree(3) == (NumType)1);
+    REQUIRE(trans.neighborBegin(0)[0] == (NumType)3);
+    REQUIRE(trans.weightBegin(0)[0] == (WeightType)40);
+    REQUIRE(trans.neighborBegin(1)[0] == (NumType)0);
+    REQUIRE(trans.weightBegin(1)[0] == (WeightType)10);
+    REQUIRE(trans.neighborBegin(1)[1] == (NumType)2);
+    REQUIRE(trans.weightBegin(1)[1] == (WeightType)30);
+    REQUIRE(trans.neighborBegin(3)[0] == (NumType)0);
+    REQUIRE(trans.weightBegin(3)[0] == (WeightType)20);
+}
+
+TEST_CASE("Invalid") {
+    REQUIRE_THROWS_AS(CSRGraph({}, {}, {}), std::invalid_argument);
+    REQUIRE_THROWS_AS(CSRGraph({0, 2}, {1}, {1}), std::invalid_argument);
+    REQUIRE_THROWS_AS(CSRGraph({0, 1}, {1}, {}), std::invalid_argument);
+}
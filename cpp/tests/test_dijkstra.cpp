@@ -1,6 +1,7 @@
 #include "catch2/catch_amalgamated.hpp"
 #include "jumble/dijkstra.hpp"
 #include <string>
+#include <cstdint>
 
 typedef jumble::DijkGraph<std::string> G;
 typedef G::NumType NumType;
@@ -68,3 +69,45 @@ TEST_CASE("Complex") {
         }
     }
 }
+
+TEST_CASE("Types") {
+    typedef jumble::DijkGraph<int, std::uint32_t, double> DG;
+    DG graph(4, DG::LIST);
+    graph.setWeight(0, 1, 0.5);
+    graph.setWeight(0, 2, 2.25);
+    graph.setWeight(1, 2, 0.75);
+    graph.setWeight(2, 3, 0.125);
+    jumble::dijkstra(graph, 0);
+    std::vector<double> expectDist = {0, 0.5, 1.25, 1.375};
+    for (std::uint32_t i = 0; i < graph.getSize(); ++i) {
+        REQUIRE(graph[i].dist == expectDist[i]);
+    }
+    std::vector<std::uint32_t> expectPrev = {5, 0, 1, 2};
+    for (std::uint32_t i = 0; i < graph.getSize(); ++i) {
+        REQUIRE(graph[i].prev == expectPrev[i]);
+    }
+}
+
+TEST_CASE("NarrowWeight") {
+    // Paths longer than the maximum weight are unreachable rather than wrapped around
+    typedef jumble::DijkGraph<int, std::uint32_t, std::uint16_t> NG;
+    NG graph(4, NG::LIST);
+    graph.setWeight(0, 1, 40000);
+    graph.setWeight(1, 2, 40000);
+    graph.setWeight(0, 3, 65534);
+    graph.setWeight(2, 3, 1);
+    jumble::dijkstra(graph, (std::uint32_t)0);
+    REQUIRE(graph[1].dist == 40000);
+    REQUIRE(graph[2].dist == NG::MAX_WEIGHT);
+    REQUIRE(graph[2].prev == (std::uint32_t)5);
+    REQUIRE(graph[3].dist == 65534);
+    REQUIRE(graph[3].prev == (std::uint32_t)0);
+
+    typedef jumble::DijkGraph<int, std::uint32_t, std::uint32_t> UG;
+    UG graph32(3, UG::LIST);
+    graph32.setWeight(0, 1, 3000000000u);
+    graph32.setWeight(1, 2, 3000000000u);
+    jumble::dijkstra(graph32, (std::uint32_t)0);
+    REQUIRE(graph32[1].dist == 3000000000u);
+    REQUIRE(graph32[2].dist == UG::MAX_WEIGHT);
+}
@@ -0,0 +1,162 @@
+#include "catch2/catch_amalgamated.hpp"
+#include "jumble/edge_list_loader.hpp"
+#include "jumble/util/random.hpp"
+#include <fstream>
+#include <sstream>
+#include <cstdio>
+#include <cstring>
+#include <cstdint>
+
+using jumble::CSRGraph;
+using jumble::EdgeListLoader;
+using jumble::ThreadPool;
+
+typedef jumble::Graph<int> G;
+typedef CSRGraph::NumType NumType;
+typedef CSRGraph::WeightType WeightType;
+
+static CSRGraph parse(EdgeListLoader& loader, const std::string& str, const NumType n = 0) {
+    return loader.parse(str.data(), str.size(), n);
+}
+
+// Return true if two graphs have the same edges in the same order
+static bool equal(const CSRGraph& g1, const CSRGraph& g2) {
+    if (g1.getSize() != g2.getSize() || g1.getEdgeCount() != g2.getEdgeCount()) {
+        return false;
+    }
+    for (NumType v = 0; v < g1.getSize(); ++v) {
+        if (g1.getDegree(v) != g2.getDegree(v)) {
+            return false;
+        }
+        for (NumType i = 0; i < g1.getDegree(v); ++i) {
+            if (g1.neighborBegin(v)[i] != g2.neighborBegin(v)[i]
+                || g1.weightBegin(v)[i] != g2.weightBegin(v)[i]) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+TEST_CASE("Parse") {
+    ThreadPool pool(2);
+    EdgeListLoader loader(pool);
+
+    std::string str =
+        "# comment\n"
+        "% comment\n"
+        "0 3 -5\n"
+        "\n"
+        "  0\t1\n"
+        "2 1 +7 \r\n"
+        "0 3 9\n"
+        "3 0 2147483647\n"
+        "4 2 -2147483648";
+    CSRGraph graph = parse(loader, str);
+    CSRGraph expect({0, 2, 2, 3, 3, 3}, {1, 3, 1}, {1, 9, 7});
+    REQUIRE(equal(graph, expect));
+    REQUIRE(loader.getStats().edges == (NumType)6);
+    REQUIRE(loader.getStats().bytes == str.size());
+
+    REQUIRE(parse(loader, "").getSize() == (NumType)0);
+    REQUIRE(parse(loader, "", 3).getSize() == (NumType)3);
+    REQUIRE(parse(loader, "1 0\n", 5).getSize() == (NumType)5);
+}
+
+TEST_CASE("ParseError") {
+    ThreadPool pool(2);
+    EdgeListLoader loader(pool);
+    for (auto str : {"1", "1 ", "a 1", "1 2 3 4", "1 2 x", "1\n2 3", "1 2 -", "1-2",
+                     "1 2-3", "1 2+3\n", "99999999999999999999999 1", "0 1 2147483648", "0 1 -2147483649"}) {
+        REQUIRE_THROWS_AS(parse(loader, str), std::runtime_error);
+    }
+}
+
+TEST_CASE("ParseLarge") {
+    ThreadPool pool(4);
+    EdgeListLoader loader(pool);
+    auto random = jumble::Random::getInstance();
+
+    // Large enough to be split into many chunks
+    const NumType n = 1000;
+    G expect(n, G::LIST);
+    std::ostringstream oss;
+    for (int i = 0; i < 100000; ++i) {
+        NumType from = random->nextInt<NumType>(0, n - 1);
+        NumType to = random->nextInt<NumType>(0, n - 1);
+        WeightType w = random->nextInt<WeightType>(-100, 100);
+        oss << from << " " << to << " " << w << "\n";
+        expect.setWeight(from, to, w);
+    }
+    std::string str = oss.str();
+    CSRGraph graph = parse(loader, str, n);
+    REQUIRE(loader.getStats().edges == (NumType)100000);
+    REQUIRE(loader.getStats().edgesPerSecond() > 0);
+
+    // Compare with setWeight() of each line in order
+    REQUIRE(graph.getSize() == n);
+    for (NumType v = 0; v < n; ++v) {
+        auto neighbors = expect.getNeighbors(v);
+        std::sort(neighbors.begin(), neighbors.end());
+        REQUIRE(graph.getDegree(v) == neighbors.size());
+        for (NumType i = 0; i < neighbors.size(); ++i) {
+            REQUIRE(graph.neighborBegin(v)[i] == neighbors[i]);
+            REQUIRE(graph.weightBegin(v)[i] == expect.getWeight(v, neighbors[i]));
+        }
+    }
+}
+
+TEST_CASE("LoadFile") {
+    const char *path = "test_edge_list_loader.txt";
+    {
+        std::ofstream ofs(path);
+        ofs << "0 1 10\n0 2 20\n1 2 30\n2 2 40\n";
+    }
+    ThreadPool pool(2);
+    EdgeListLoader loader(pool);
+
+    CSRGraph graph = loader.load(path);
+    REQUIRE(equal(graph, CSRGraph({0, 2, 3, 4}, {1, 2, 2, 2}, {10, 20, 30, 40})));
+
+    for (auto type : {G::LIST, G::MATRIX}) {
+        G g = loader.loadGraph<int>(path, type, 4);
+        REQUIRE(g.getSize() == (NumType)4);
+        REQUIRE(g.getWeight(0, 1) == (WeightType)10);
+        REQUIRE(g.getWeight(0, 2) == (WeightType)20);
+        REQUIRE(g.getWeight(1, 2) == (WeightType)30);
+        REQUIRE(G::isINF(g.getWeight(1, 0)));
+        REQUIRE(G::isINF(g.getWeight(3, 0)));
+        REQUIRE(g.getNeighbors(0).size() == (std::size_t)2);
+    }
+    std::remove(path);
+
+    REQUIRE_THROWS_AS(loader.load(path), std::runtime_error);
+}
+
+TEST_CASE("ParseTypes") {
+    ThreadPool pool(2);
+    {
+        jumble::BasicEdgeListLoader<std::uint32_t, double> loader(pool);
+        std::string str = "0 1 1.5\n0 2 -2.5e-3\n1 0 +7\n1 2 .25E2\n2 0 0.1\n";
+        auto graph = loader.parse(str.data(), str.size());
+        REQUIRE(graph.getSize() == (std::uint32_t)3);
+        REQUIRE(graph.weightBegin(0)[0] == 1.5);
+        REQUIRE(graph.weightBegin(0)[1] == -2.5e-3);
+        REQUIRE(graph.weightBegin(1)[0] == 7);
+        REQUIRE(graph.weightBegin(1)[1] == 25);
+        REQUIRE(graph.weightBegin(2)[0] == 0.1);
+        for (auto bad : {"0 1 .", "0 1 1e", "0 1 e5", "0 1 1.5x", "0 1-2.5"}) {
+            REQUIRE_THROWS_AS(loader.parse(bad, std::strlen(bad)), std::runtime_error);
+        }
+    }
+    {
+        jumble::BasicEdgeListLoader<std::uint32_t, std::uint16_t> loader(pool);
+        std::string str = "0 1 65535\n0 2 0\n";
+        auto graph = loader.parse(str.data(), str.size());
+        REQUIRE(graph.getEdgeCount() == (std::uint32_t)1);  // The first edge is infinite
+        REQUIRE(graph.weightBegin(0)[0] == (std::uint16_t)0);
+        for (auto bad : {"0 1 -1", "0 1 65536", "4294967295 1"}) {
+            REQUIRE_THROWS_AS(loader.parse(bad, std::strlen(bad)), std::runtime_error);
+        }
+    }
+}
@@ -1,6 +1,8 @@
 #include "catch2/catch_amalgamated.hpp"
 #include "jumble/graph.hpp"
 #include <string>
+#include <limits>
+#include <cstdint>
 
 typedef jumble::Graph<std::string> G;
 typedef G::NumType NumType;
@@ -131,3 +133,83 @@ TEST_CASE("Matrix") {
     auto n2 = graph.getNeighbors(2);
     REQUIRE(n2.size() == (decltype(n2)::size_type)0);
 }
+
+TEST_CASE("Bitset") {
+    G graph(130, G::BITSET);
+    REQUIRE(graph.getSize() == (NumType)130);
+
+    graph[0] = "AA";
+    graph[129] = "BB";
+    REQUIRE(graph[0] == "AA");
+    REQUIRE(graph[129] == "BB");
+
+    // Test weights
+    REQUIRE(graph.getWeight(0, 0) == (WeightType)0);
+    REQUIRE(G::isINF(graph.getWeight(0, 1)));
+    REQUIRE(G::isINF(graph.getWeight(1, 0)));
+
+    graph.setWeight(0, 1, 10);
+    graph.setWeight(0, 64, 20);
+    graph.setWeight(0, 129, 30);
+    graph.setWeight(5, 5, 40);  // Self loop is ignored
+    graph.addEdge(1, 2, 50);
+    REQUIRE(graph.getWeight(0, 1) == (WeightType)1);
+    REQUIRE(graph.getWeight(0, 64) == (WeightType)1);
+    REQUIRE(graph.getWeight(0, 129) == (WeightType)1);
+    REQUIRE(graph.getWeight(1, 2) == (WeightType)1);
+    REQUIRE(graph.getWeight(5, 5) == (WeightType)0);
+    REQUIRE(G::isINF(graph.getWeight(1, 0)));
+    REQUIRE(G::isINF(graph.getWeight(0, 2)));
+
+    graph.setWeight(0, 64, G::MAX_WEIGHT);
+    REQUIRE(G::isINF(graph.getWeight(0, 64)));
+
+    // Test neighbors
+    auto n0 = graph.getNeighbors(0);
+    REQUIRE(n0.size() == (decltype(n0)::size_type)2);
+    REQUIRE(n0[0] == 1);
+    REQUIRE(n0[1] == 129);
+
+    auto n5 = graph.getNeighbors(5);
+    REQUIRE(n5.size() == (decltype(n5)::size_type)0);
+
+    // Test common neighbors
+    graph.setWeight(2, 1, 1);
+    graph.setWeight(2, 129, 1);
+    REQUIRE(graph.countCommonNeighbors(0, 2) == (NumType)2);
+    REQUIRE(graph.countCommonNeighbors(0, 1) == (NumType)0);
+}
+
+TEST_CASE("Types") {
+    {
+        typedef jumble::Graph<int, std::uint32_t, float> FG;
+        REQUIRE(FG::MAX_WEIGHT == std::numeric_limits<float>::infinity());
+        REQUIRE(FG::MIN_WEIGHT == -std::numeric_limits<float>::infinity());
+
+        FG graph(3, FG::LIST);
+        graph.setWeight(0, 1, 1.5f);
+        graph.setWeight(0, 2, -0.25f);
+        graph.setWeight(1, 2, FG::MIN_WEIGHT);
+        REQUIRE(graph.getWeight(0, 1) == 1.5f);
+        REQUIRE(graph.getWeight(0, 2) == -0.25f);
+        REQUIRE(FG::isINF(graph.getWeight(1, 2)));
+        REQUIRE(FG::isINF(graph.getWeight(2, 0)));
+        REQUIRE(graph.getNeighbors(0) == std::vector<std::uint32_t>({1, 2}));
+        REQUIRE(graph.getNeighbors(1).empty());
+    }
+    {
+        typedef jumble::Graph<int, std::uint32_t, std::uint16_t> UG;
+        REQUIRE(UG::MAX_WEIGHT == (std::uint16_t)65535);
+        REQUIRE(UG::MIN_WEIGHT == UG::MAX_WEIGHT);
+
+        for (auto type : {UG::LIST, UG::MATRIX}) {
+            UG graph(3, type);
+            graph.setWeight(0, 1, 0);  // Zero is a valid unsigned weight
+            graph.setWeight(0, 2, 7);
+            REQUIRE(graph.getWeight(0, 1) == (std::uint16_t)0);
+            REQUIRE(graph.getWeight(0, 2) == (std::uint16_t)7);
+            REQUIRE(UG::isINF(graph.getWeight(1, 0)));
+            REQUIRE(graph.getNeighbors(0) == std::vector<std::uint32_t>({1, 2}));
+        }
+    }
+}
@@ -0,0 +1,179 @@
+#include "catch2/catch_amalgamated.hpp"
+#include "jumble/graph_analytics.hpp"
+#include "jumble/util/random.hpp"
+#include <queue>
+#include <algorithm>
+#include <numeric>
+
+using jumble::CSRGraph;
+using jumble::ThreadPool;
+
+typedef jumble::Graph<int> G;
+typedef CSRGraph::NumType NumType;
+
+// Build a random directed graph with 'n' vertices and about 'n * deg' edges
+static CSRGraph randomGraph(const NumType n, const NumType deg) {
+    auto random = jumble::Random::getInstance();
+    G graph(n, G::LIST);
+    for (NumType i = 0; i < n * deg; ++i) {
+        graph.setWeight(random->nextInt<NumType>(0, n - 1), random->nextInt<NumType>(0, n - 1), 1);
+    }
+    return CSRGraph(graph);
+}
+
+// Return the depth of each vertex by serial BFS, or n + 1 if unreachable
+static std::vector<NumType> serialDepth(const CSRGraph& graph, const NumType src) {
+    std::vector<NumType> depth(graph.getSize(), graph.getSize() + 1);
+    std::queue<NumType> q;
+    depth[src] = 0;
+    q.push(src);
+    while (!q.empty()) {
+        NumType u = q.front();
+        q.pop();
+        for (auto it = graph.neighborBegin(u); it != graph.neighborEnd(u); ++it) {
+            if (depth[*it] == graph.getSize() + 1) {
+                depth[*it] = depth[u] + 1;
+                q.push(*it);
+            }
+        }
+    }
+    return depth;
+}
+
+TEST_CASE("BFS") {
+    ThreadPool pool(4);
+    G src(5, G::LIST);
+    src.setWeight(0, 1, 1);
+    src.setWeight(1, 2, 1);
+    src.setWeight(0, 3, 1);
+    src.setWeight(3, 2, 1);
+    CSRGraph graph(src);
+
+    auto parent = jumble::bfs(graph, 0, pool);
+    REQUIRE(parent[0] == (NumType)0);
+    REQUIRE(parent[1] == (NumType)0);
+    REQUIRE((parent[2] == (NumType)1 || parent[2] == (NumType)3));
+    REQUIRE(parent[3] == (NumType)0);
+    REQUIRE(parent[4] == (NumType)6);
+}
+
+TEST_CASE("BFSRandom") {
+    ThreadPool pool(4);
+    for (NumType deg : {1, 4, 16}) {
+        CSRGraph graph = randomGraph(2000, deg);
+        CSRGraph trans = graph.transpose();
+        auto parent = jumble::bfs(graph, trans, 0, pool);
+        auto depth = serialDepth(graph, 0);
+        const NumType none = graph.getSize() + 1;
+        for (NumType v = 0; v < graph.getSize(); ++v) {
+            if (depth[v] == none) {
+                REQUIRE(parent[v] == none);
+            } else if (v != 0) {
+                // The parent must be on the previous level and have an edge to 'v'
+                NumType p = parent[v];
+                REQUIRE(p < graph.getSize());
+                REQUIRE(depth[p] + 1 == depth[v]);
+                REQUIRE(std::find(graph.neighborBegin(p), graph.neighborEnd(p), v) != graph.neighborEnd(p));
+            }
+        }
+    }
+}
+
+TEST_CASE("ConnectedComponents") {
+    ThreadPool pool(4);
+    G src(7, G::LIST);
+    src.setWeight(1, 0, 1);
+    src.setWeight(2, 4, 1);
+    src.setWeight(6, 4, 1);
+    src.setWeight(5, 5, 1);
+    CSRGraph graph(src);
+
+    auto comp = jumble::connectedComponents(graph, pool);
+    std::vector<NumType> expect = {0, 0, 2, 3, 2, 5, 2};
+    REQUIRE(comp == expect);
+}
+
+TEST_CASE("ConnectedComponentsRandom") {
+    ThreadPool pool(4);
+    CSRGraph graph = randomGraph(3000, 1);
+    CSRGraph trans = graph.transpose();
+    auto comp = jumble::connectedComponents(graph, pool);
+
+    // Compare with serial BFS on the undirected graph
+    std::vector<NumType> expect(graph.getSize(), graph.getSize());
+    for (NumType s = 0; s < graph.getSize(); ++s) {
+        if (expect[s] != graph.getSize()) {
+            continue;
+        }
+        std::queue<NumType> q;
+        expect[s] = s;
+        q.push(s);
+        while (!q.empty()) {
+            NumType u = q.front();
+            q.pop();
+            for (const CSRGraph *g : {&graph, &trans}) {
+                for (auto it = g->neighborBegin(u); it != g->neighborEnd(u); ++it) {
+                    if (expect[*it] == graph.getSize()) {
+                        expect[*it] = s;
+                        q.push(*it);
+                    }
+                }
+            }
+        }
+    }
+    REQUIRE(comp == expect);
+}
+
+TEST_CASE("PageRank") {
+    ThreadPool pool(4);
+    {
+        // A directed cycle has uniform ranks
+        CSRGraph graph({0, 1, 2, 3, 4}, {1, 2, 3, 0}, {1, 1, 1, 1});
+        auto rank = jumble::pageRank(graph, pool);
+        for (const auto &r : rank) {
+            REQUIRE(r == Catch::Approx(0.25));
+        }
+    }
+    {
+        // Vertices 0 and 3 have no in-edges and point to 1, which points to the dangling vertex 2
+        CSRGraph graph({0, 1, 2, 2, 3}, {1, 2, 1}, {1, 1, 1});
+        auto rank = jumble::pageRank(graph, pool, 0.85, 1e-12, 1000);
+        REQUIRE(std::accumulate(rank.begin(), rank.end(), 0.0) == Catch::Approx(1.0));
+        REQUIRE(rank[0] == Catch::Approx(rank[3]));
+        REQUIRE(rank[1] > rank[0]);
+        REQUIRE(rank[2] > rank[1]);
+    }
+}
+
+TEST_CASE("Triangles") {
+    ThreadPool pool(4);
+    auto random = jumble::Random::getInstance();
+
+    // Compare the storage types with brute force on a random undirected graph
+    const NumType n = 300;
+    G list(n, G::LIST), matrix(n, G::MATRIX), bitset(n, G::BITSET);
+    for (NumType u = 0; u < n; ++u) {
+        for (NumType v = u + 1; v < n; ++v) {
+            if (random->nextInt(0, 9) < 3) {
+                for (G *g : {&list, &matrix, &bitset}) {
+                    g->setWeight(u, v, 1);
+                    g->setWeight(v, u, 1);
+                }
+            }
+        }
+    }
+    std::uint64_t expect = 0;
+    for (NumType u = 0; u < n; ++u) {
+        for (NumType v = u + 1; v < n; ++v) {
+            for (NumType w = v + 1; w < n; ++w) {
+                if (!G::isINF(bitset.getWeight(u, v)) && !G::isINF(bitset.getWeight(v, w))
+                    && !G::isINF(bitset.getWeight(u, w))) {
+                    ++expect;
+                }
+            }
+        }
+    }
+    REQUIRE(jumble::countTriangles(list, pool) == expect);
+    REQUIRE(jumble::countTriangles(matrix, pool) == expect);
+    REQUIRE(jumble::countTriangles(bitset, pool) == expect);
+}
@@ -0,0 +1,140 @@
+#include "catch2/catch_amalgamated.hpp"
+#include "jumble/graph_file.hpp"
+#include <fstream>
+#include <functional>
+#include <cstdio>
+#include <cstddef>
+#include <cstdint>
+
+using jumble::CSRGraph;
+using jumble::GraphFile;
+using jumble::MappedGraph;
+
+typedef jumble::Graph<double> G;
+typedef CSRGraph::NumType NumType;
+typedef CSRGraph::WeightType WeightType;
+
+static const char *const PATH = "test_graph_file.bin";
+
+// Overwrite a number at a byte offset of the file
+template<typename T>
+static void patch(const std::size_t off, const T val) {
+    std::fstream fs(PATH, std::ios::binary | std::ios::in | std::ios::out);
+    fs.seekp((std::streamoff)off);
+    fs.write(reinterpret_cast<const char*>(&val), sizeof(val));
+}
+
+TEST_CASE("WriteAndMap") {
+    G src(4, G::LIST);
+    for (NumType v = 0; v < src.getSize(); ++v) {
+        src[v] = v * 1.5;
+    }
+    src.setWeight(0, 1, 10);
+    src.setWeight(0, 3, -20);
+    src.setWeight(2, 1, 30);
+    src.setWeight(3, 0, 40);
+    GraphFile::write(PATH, src);
+
+    CSRGraph expect(src);
+    CSRGraph graph;
+    {
+        MappedGraph<double> mapped(PATH);
+        REQUIRE(mapped.getSize() == (NumType)4);
+        for (NumType v = 0; v < mapped.getSize(); ++v) {
+            REQUIRE(mapped[v] == v * 1.5);
+        }
+        graph = mapped.getGraph();
+    }
+
+    // The graph keeps the mapping alive
+    REQUIRE(graph.getSize() == expect.getSize());
+    REQUIRE(graph.getEdgeCount() == expect.getEdgeCount());
+    for (NumType v = 0; v < graph.getSize(); ++v) {
+        REQUIRE(graph.getDegree(v) == expect.getDegree(v));
+        for (NumType i = 0; i < graph.getDegree(v); ++i) {
+            REQUIRE(graph.neighborBegin(v)[i] == expect.neighborBegin(v)[i]);
+            REQUIRE(graph.weightBegin(v)[i] == expect.weightBegin(v)[i]);
+        }
+    }
+    std::remove(PATH);
+}
+
+TEST_CASE("EmptyGraph") {
+    GraphFile::write(PATH, G(0));
+    MappedGraph<double> mapped(PATH);
+    REQUIRE(mapped.getSize() == (NumType)0);
+    REQUIRE(mapped.getGraph().getEdgeCount() == (NumType)0);
+    std::remove(PATH);
+}
+
+TEST_CASE("InvalidFile") {
+    REQUIRE_THROWS_AS(MappedGraph<double>("not_exist.bin"), std::runtime_error);
+
+    {
+        std::ofstream ofs(PATH, std::ios::binary);
+        ofs << std::string(100, 'x');
+    }
+    REQUIRE_THROWS_AS(MappedGraph<double>(PATH), std::runtime_error);
+
+    // Different value type
+    GraphFile::write(PATH, G(3));
+    REQUIRE_THROWS_AS(MappedGraph<int>(PATH), std::runtime_error);
+
+    // Truncated
+    {
+        std::ifstream ifs(PATH, std::ios::binary);
+        std::string content((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
+        ifs.close();
+        std::ofstream ofs(PATH, std::ios::binary | std::ios::trunc);
+        ofs.write(content.data(), content.size() - 1);
+    }
+    REQUIRE_THROWS_AS(MappedGraph<double>(PATH), std::runtime_error);
+    std::remove(PATH);
+}
+
+TEST_CASE("CorruptFile") {
+    // 0 -> 1, 0 -> 2, 2 -> 1
+    G src(3, G::LIST);
+    src.setWeight(0, 1, 1);
+    src.setWeight(0, 2, 1);
+    src.setWeight(2, 1, 1);
+    const std::size_t header = sizeof(GraphFile::Header);
+    const std::size_t offsets = header, targets = header + 4 * sizeof(NumType);
+
+    auto corrupt = [&](std::function<void()> f) {
+        GraphFile::write(PATH, src);
+        REQUIRE_NOTHROW(MappedGraph<double>(PATH));
+        f();
+        REQUIRE_THROWS_AS(MappedGraph<double>(PATH), std::runtime_error);
+    };
+    // Huge counts whose sizes wrap around
+    corrupt([&] { patch(offsetof(GraphFile::Header, vertexCount), (std::uint64_t)1 << 61); });
+    corrupt([&] { patch(offsetof(GraphFile::Header, edgeCount), ~(std::uint64_t)0 / sizeof(NumType) + 2); });
+    // Offsets not starting at 0, not ending at the edge count, or descending
+    corrupt([&] { patch(offsets, (NumType)1); });
+    corrupt([&] { patch(offsets + 3 * sizeof(NumType), (NumType)2); });
+    corrupt([&] { patch(offsets + sizeof(NumType), (NumType)3); });
+    // Edge target out of range
+    corrupt([&] { patch(targets + 2 * sizeof(NumType), (NumType)3); });
+    std::remove(PATH);
+}
+
+TEST_CASE("Types") {
+    typedef jumble::Graph<std::uint16_t, std::uint32_t, float> FG;
+    FG src(3, FG::MATRIX);
+    src[1] = 7;
+    src.setWeight(0, 1, 0.5f);
+    src.setWeight(2, 1, -1.5f);
+    GraphFile::write(PATH, src);
+
+    jumble::MappedGraph<std::uint16_t, std::uint32_t, float> mapped(PATH);
+    REQUIRE(mapped[1] == 7);
+    REQUIRE(mapped.getGraph().getEdgeCount() == (std::uint32_t)2);
+    REQUIRE(mapped.getGraph().weightBegin(0)[0] == 0.5f);
+    REQUIRE(mapped.getGraph().weightBegin(2)[0] == -1.5f);
+
+    // Same sizes, different kinds of weights
+    typedef jumble::MappedGraph<std::uint16_t, std::uint32_t, std::int32_t> IntMapped;
+    REQUIRE_THROWS_AS(IntMapped(PATH), std::runtime_error);
+    std::remove(PATH);
+}
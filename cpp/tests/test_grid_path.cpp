@@ -0,0 +1,127 @@
+#include "catch2/catch_amalgamated.hpp"
+#include "jumble/grid_path.hpp"
+#include "jumble/util/random.hpp"
+#include <string>
+#include <vector>
+#include <deque>
+#include <stdexcept>
+
+using jumble::GridMap;
+
+typedef GridMap::SizeType SizeType;
+typedef GridMap::Cell Cell;
+
+// Return the length of the shortest path between two cells by BFS, or -1 if there is none
+static int bfsLength(const std::vector<std::string>& rows, const Cell& from, const Cell& to) {
+    std::vector<std::vector<int>> dist(rows.size(), std::vector<int>(rows[0].size(), -1));
+    std::deque<Cell> queue = {from};
+    dist[from.row][from.col] = 0;
+    while (!queue.empty()) {
+        Cell cur = queue.front();
+        queue.pop_front();
+        if (cur == to) {
+            return dist[cur.row][cur.col];
+        }
+        const int dr[] = {0, -1, 0, 1}, dc[] = {-1, 0, 1, 0};
+        for (int i = 0; i < 4; ++i) {
+            int r = (int)cur.row + dr[i], c = (int)cur.col + dc[i];
+            if (r >= 0 && c >= 0 && r < (int)rows.size() && c < (int)rows[0].size()
+                && rows[r][c] != '#' && dist[r][c] < 0) {
+                dist[r][c] = dist[cur.row][cur.col] + 1;
+                queue.push_back({(SizeType)r, (SizeType)c});
+            }
+        }
+    }
+    return -1;
+}
+
+// Return true if a path moves between adjacent free cells
+static bool isValid(const GridMap& map, const std::vector<Cell>& path) {
+    for (SizeType i = 0; i < path.size(); ++i) {
+        if (map.isBlocked(path[i])) {
+            return false;
+        }
+        if (i) {
+            SizeType dR = path[i].row > path[i - 1].row ? path[i].row - path[i - 1].row
+                                                        : path[i - 1].row - path[i].row;
+            SizeType dC = path[i].col > path[i - 1].col ? path[i].col - path[i - 1].col
+                                                        : path[i - 1].col - path[i].col;
+            if (dR + dC != 1) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+TEST_CASE("Maze") {
+    std::vector<std::string> rows = {
+        "..#.....",
+        "..#.###.",
+        "..#...#.",
+        "..###.#.",
+        "......#.",
+    };
+    GridMap map(rows);
+    REQUIRE(map.getRowCount() == (SizeType)5);
+    REQUIRE(map.getColCount() == (SizeType)8);
+    REQUIRE(map.isBlocked({0, 2}));
+    REQUIRE(!map.isBlocked({0, 0}));
+
+    std::vector<Cell> path = map.findPath({0, 0}, {4, 7});
+    REQUIRE(path.size() == (SizeType)24);
+    REQUIRE(path.front() == Cell{0, 0});
+    REQUIRE(path.back() == Cell{4, 7});
+    REQUIRE(isValid(map, path));
+    REQUIRE(map.getStats().expansions > (SizeType)0);
+
+    path = map.findPath({2, 3}, {2, 3});
+    REQUIRE(path.size() == (SizeType)1);
+}
+
+TEST_CASE("Unreachable") {
+    GridMap map({
+        "..#..",
+        "..#..",
+        "###..",
+    });
+    REQUIRE(map.findPath({0, 0}, {0, 4}).empty());
+    REQUIRE(map.findPath({0, 0}, {0, 2}).empty());  // Blocked ending cell
+    REQUIRE(map.findPath({0, 3}, {2, 4}).size() == (SizeType)4);
+}
+
+TEST_CASE("Random") {
+    jumble::Random *random = jumble::Random::getInstance();
+    for (int t = 0; t < 20; ++t) {
+        std::vector<std::string> rows(30, std::string(40, '.'));
+        for (auto &r : rows) {
+            for (auto &c : r) {
+                if (random->nextInt(0, 99) < 30) {
+                    c = '#';
+                }
+            }
+        }
+        GridMap map(rows);
+        for (int i = 0; i < 10; ++i) {
+            Cell from = {(SizeType)random->nextInt(0, 29), (SizeType)random->nextInt(0, 39)};
+            Cell to = {(SizeType)random->nextInt(0, 29), (SizeType)random->nextInt(0, 39)};
+            std::vector<Cell> path = map.findPath(from, to);
+            int len = map.isBlocked(from) || map.isBlocked(to) ? -1 : bfsLength(rows, from, to);
+            if (len < 0) {
+                REQUIRE(path.empty());
+            } else {
+                REQUIRE(path.size() == (SizeType)len + 1);
+                REQUIRE(path.front() == from);
+                REQUIRE(path.back() == to);
+                REQUIRE(isValid(map, path));
+            }
+        }
+    }
+}
+
+TEST_CASE("InvalidMap") {
+    REQUIRE_THROWS_AS(GridMap(std::vector<std::string>()), std::invalid_argument);
+    REQUIRE_THROWS_AS(GridMap({"...", ".."}), std::invalid_argument);
+    GridMap map({"..", ".."});
+    REQUIRE_THROWS_AS(map.findPath({0, 0}, {2, 0}), std::out_of_range);
+}
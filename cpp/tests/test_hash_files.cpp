@@ -0,0 +1,41 @@
+#include "catch2/catch_amalgamated.hpp"
+#include "jumble/hash_files.hpp"
+#include "jumble/sha256.hpp"
+#include <string>
+#include <vector>
+#include <fstream>
+#include <stdexcept>
+#include <cstddef>
+#include <cstdio>
+
+TEST_CASE("Files") {
+    std::vector<std::string> paths, contents;
+    for (int i = 0; i < 10; ++i) {
+        paths.push_back("test_hash_files_" + std::to_string(i) + ".txt");
+        contents.push_back(std::string((std::size_t)i * i * 100, (char)('0' + i)));
+        std::ofstream ofs(paths.back(), std::ios::binary);
+        ofs << contents.back();
+    }
+    jumble::ThreadPool pool(3);
+    auto res = jumble::hashFiles(paths, pool);
+    REQUIRE(res.size() == paths.size());
+    REQUIRE(res[0] == "d41d8cd98f00b204e9800998ecf8427e");
+    for (std::size_t i = 0; i < paths.size(); ++i) {
+        REQUIRE(res[i] == jumble::MD5::hash(contents[i]));
+    }
+    REQUIRE(jumble::hashFiles(std::vector<std::string>(), pool).empty());
+
+    // Other digests
+    res = jumble::hashFiles<jumble::SHA256Context>(paths, pool);
+    REQUIRE(res[0] == "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855");
+    for (std::size_t i = 0; i < paths.size(); ++i) {
+        REQUIRE(res[i] == jumble::SHA256::hash(contents[i]));
+    }
+
+    std::remove(paths.back().c_str());
+    REQUIRE_THROWS_AS(jumble::hashFiles(paths, pool), std::runtime_error);
+    paths.pop_back();
+    for (const auto &path : paths) {
+        std::remove(path.c_str());
+    }
+}
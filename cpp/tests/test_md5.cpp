@@ -1,5 +1,10 @@
 #include "catch2/catch_amalgamated.hpp"
 #include "jumble/md5.hpp"
+#include <string>
+#include <cstddef>
+#include <algorithm>
+#include <vector>
+#include <thread>
 
 const auto md5 = jumble::MD5::getInstance();
 
@@ -20,3 +25,93 @@ TEST_CASE("LongString") {
     }
     REQUIRE(md5->hash(msg) == "836fb4e7ebd9ec4cd03ac50f2a888ce6");
 }
+
+TEST_CASE("Binary") {
+    std::string msg;
+    for (int i = 0; i < 1000; ++i) {
+        msg += (char)(i % 256);
+    }
+    REQUIRE(md5->hash(msg) == "cbecbdb0fdd5cec1e242493b6008cc79");
+}
+
+TEST_CASE("Streaming") {
+    jumble::MD5Context ctx;
+    REQUIRE(ctx.finalize() == "d41d8cd98f00b204e9800998ecf8427e");
+
+    // One million 'a' in pieces of every size up to two blocks
+    std::string piece(128, 'a');
+    std::size_t left = 1000000;
+    for (std::size_t len = 0; left; len = (len + 1) % piece.size()) {
+        std::size_t n = len < left ? len : left;
+        ctx.update(piece.data(), n);
+        left -= n;
+    }
+    REQUIRE(ctx.finalize() == "7707d6ae4e027c70eea2a935c2296f21");
+
+    // The context is reset after finalizing
+    const char *msg = "The quick brown fox jumps over the lazy dog";
+    ctx.update(msg, 10);
+    ctx.update(msg + 10, 33);
+    REQUIRE(ctx.finalize() == "9e107d9d372bb6826bd81d3542a419d6");
+
+    // Every split of messages around the padding boundaries
+    std::string text(130, 'x');
+    for (std::size_t len = 50; len < text.size(); ++len) {
+        std::string expect = md5->hash(text.substr(0, len));
+        for (std::size_t i = 0; i <= len; ++i) {
+            ctx.update(text.data(), i);
+            ctx.update(text.data() + i, len - i);
+            REQUIRE(ctx.finalize() == expect);
+        }
+    }
+}
+
+TEST_CASE("RawDigest") {
+    const char *msg = "The quick brown fox jumps over the lazy dog";
+    unsigned char digest[jumble::MD5Context::DIGEST_SIZE];
+    md5->hash(msg, 43, digest);
+    const unsigned char expect[] = {0x9e, 0x10, 0x7d, 0x9d, 0x37, 0x2b, 0xb6, 0x82,
+                                    0x6b, 0xd8, 0x1d, 0x35, 0x42, 0xa4, 0x19, 0xd6};
+    REQUIRE(std::equal(digest, digest + sizeof(digest), expect));
+    REQUIRE(md5->hash(msg, 43) == "9e107d9d372bb6826bd81d3542a419d6");
+
+    // The hexadecimal form is written in place
+    char hex[jumble::MD5Context::DIGEST_SIZE * 2 + 1] = {0};
+    jumble::MD5Context::toHex(digest, hex);
+    REQUIRE(std::string(hex) == "9e107d9d372bb6826bd81d3542a419d6");
+    REQUIRE(jumble::MD5Context::toHex(digest) == "9e107d9d372bb6826bd81d3542a419d6");
+
+    // Empty input may have no address
+    md5->hash(nullptr, 0, digest);
+    REQUIRE(jumble::MD5Context::toHex(digest) == "d41d8cd98f00b204e9800998ecf8427e");
+}
+
+TEST_CASE("Reentrant") {
+    // Hash from several threads at once without the singleton
+    std::vector<std::string> msgs;
+    for (int i = 0; i < 64; ++i) {
+        msgs.push_back(std::string((std::size_t)i * 37, (char)('a' + i % 26)));
+    }
+    std::vector<std::string> expect;
+    for (const auto &msg : msgs) {
+        expect.push_back(md5->hash(msg));
+    }
+    std::vector<std::vector<std::string>> res(4);
+    std::vector<std::thread> threads;
+    for (std::size_t t = 0; t < res.size(); ++t) {
+        threads.emplace_back([&msgs, &res, t] {
+            for (int r = 0; r < 50; ++r) {
+                res[t].clear();
+                for (const auto &msg : msgs) {
+                    res[t].push_back(jumble::MD5::hash(msg));
+                }
+            }
+        });
+    }
+    for (auto &th : threads) {
+        th.join();
+    }
+    for (const auto &r : res) {
+        REQUIRE(r == expect);
+    }
+}
@@ -0,0 +1,89 @@
+#include "catch2/catch_amalgamated.hpp"
+#include "jumble/md5_multi_buffer.hpp"
+#include "jumble/util/random.hpp"
+#include <string>
+#include <vector>
+#include <stdexcept>
+
+using jumble::MD5MultiBuffer;
+
+typedef MD5MultiBuffer::SizeType SizeType;
+
+static const MD5MultiBuffer::Kernel KERNELS[] = {
+    MD5MultiBuffer::SCALAR, MD5MultiBuffer::SSE2, MD5MultiBuffer::AVX2, MD5MultiBuffer::AVX512
+};
+
+TEST_CASE("Kernels") {
+    REQUIRE(MD5MultiBuffer::isSupported(MD5MultiBuffer::SCALAR));
+    REQUIRE(MD5MultiBuffer::isSupported(MD5MultiBuffer::getBestKernel()));
+    REQUIRE(MD5MultiBuffer().getKernel() == MD5MultiBuffer::getBestKernel());
+    REQUIRE(MD5MultiBuffer::getLaneCount(MD5MultiBuffer::SCALAR) == (SizeType)1);
+    REQUIRE(MD5MultiBuffer::getLaneCount(MD5MultiBuffer::SSE2) == (SizeType)4);
+    REQUIRE(MD5MultiBuffer::getLaneCount(MD5MultiBuffer::AVX2) == (SizeType)8);
+    REQUIRE(MD5MultiBuffer::getLaneCount(MD5MultiBuffer::AVX512) == (SizeType)16);
+    for (auto k : KERNELS) {
+        if (!MD5MultiBuffer::isSupported(k)) {
+            REQUIRE_THROWS_AS(MD5MultiBuffer(k), std::invalid_argument);
+        }
+    }
+}
+
+TEST_CASE("Known") {
+    std::vector<std::string> msgs = {
+        "",
+        "TastyLib",
+        "The quick brown fox jumps over the lazy dog",
+        "The quick brown fox jumps over the lazy dog.",
+    };
+    std::vector<std::string> expect = {
+        "d41d8cd98f00b204e9800998ecf8427e",
+        "2dabbfd553b67530e4892eb9481121fa",
+        "9e107d9d372bb6826bd81d3542a419d6",
+        "e4d909c290d0fb1ca068ffaddf22cbd0",
+    };
+    for (auto k : KERNELS) {
+        if (MD5MultiBuffer::isSupported(k)) {
+            REQUIRE(MD5MultiBuffer(k).hash(msgs) == expect);
+            REQUIRE(MD5MultiBuffer(k).hash(std::vector<std::string>()).empty());
+        }
+    }
+}
+
+TEST_CASE("Random") {
+    // Messages of every length around the padding boundaries, in random order
+    jumble::Random *random = jumble::Random::getInstance();
+    std::vector<std::string> msgs;
+    for (int len = 0; len < 300; ++len) {
+        std::string msg(len, '\0');
+        for (auto &c : msg) {
+            c = (char)random->nextInt(0, 255);
+        }
+        msgs.insert(msgs.begin() + random->nextInt(0, (int)msgs.size()), msg);
+    }
+    std::vector<std::string> expect;
+    for (const auto &msg : msgs) {
+        expect.push_back(jumble::MD5::getInstance()->hash(msg));
+    }
+    for (auto k : KERNELS) {
+        if (MD5MultiBuffer::isSupported(k)) {
+            REQUIRE(MD5MultiBuffer(k).hash(msgs) == expect);
+        }
+    }
+}
+
+TEST_CASE("RawDigests") {
+    std::string msg(1000, 'x');
+    std::vector<const void*> data = {msg.data(), msg.data() + 1, msg.data() + 500};
+    std::vector<SizeType> lens = {1000, 999, 3};
+    unsigned char digests[3 * MD5MultiBuffer::DIGEST_SIZE];
+    MD5MultiBuffer().hash(data.data(), lens.data(), 3, digests);
+    for (SizeType i = 0; i < 3; ++i) {
+        unsigned char expect[MD5MultiBuffer::DIGEST_SIZE];
+        jumble::MD5Context ctx;
+        ctx.update(data[i], lens[i]);
+        ctx.finalize(expect);
+        for (SizeType j = 0; j < MD5MultiBuffer::DIGEST_SIZE; ++j) {
+            REQUIRE(digests[i * MD5MultiBuffer::DIGEST_SIZE + j] == expect[j]);
+        }
+    }
+}
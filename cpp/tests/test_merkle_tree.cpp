@@ -0,0 +1,133 @@
+#include "catch2/catch_amalgamated.hpp"
+#include "jumble/merkle_tree.hpp"
+#include "jumble/sha256.hpp"
+#include "jumble/xxhash.hpp"
+#include "jumble/util/random.hpp"
+#include <string>
+#include <vector>
+#include <fstream>
+#include <algorithm>
+#include <stdexcept>
+#include <cstdio>
+#include <cstddef>
+
+using jumble::MerkleTree;
+using jumble::MD5Context;
+using jumble::ThreadPool;
+
+typedef MerkleTree<>::SizeType SizeType;
+
+static std::string randomText(const SizeType len) {
+    auto random = jumble::Random::getInstance();
+    std::string res(len, '\0');
+    for (auto &c : res) {
+        c = (char)random->nextInt(0, 255);
+    }
+    return res;
+}
+
+// The digest of a leaf or inner node
+static std::string nodeDigest(const char prefix, const std::string& content) {
+    MD5Context ctx;
+    ctx.update(&prefix, 1);
+    ctx.update(content.data(), content.size());
+    unsigned char digest[MD5Context::DIGEST_SIZE];
+    ctx.finalize(digest);
+    return std::string((const char*)digest, sizeof(digest));
+}
+
+TEST_CASE("Structure") {
+    ThreadPool pool(2);
+    MerkleTree<> tree(pool, 10);
+    std::string text = randomText(25);
+    tree.build(text.data(), text.size());
+    REQUIRE(tree.getChunkCount() == (SizeType)3);
+    REQUIRE(tree.getLength() == (SizeType)25);
+
+    std::string l0 = nodeDigest(0, text.substr(0, 10));
+    std::string l1 = nodeDigest(0, text.substr(10, 10));
+    std::string l2 = nodeDigest(0, text.substr(20));
+    REQUIRE(std::string((const char*)tree.getChunkDigest(2), 16) == l2);
+    std::string root = nodeDigest(1, nodeDigest(1, l0 + l1) + l2);
+    REQUIRE(std::string((const char*)tree.getRoot(), 16) == root);
+    REQUIRE(tree.getRootHex() == MD5Context::toHex((const unsigned char*)root.data()));
+
+    // An empty message has one empty chunk
+    tree.build(nullptr, 0);
+    REQUIRE(tree.getChunkCount() == (SizeType)1);
+    REQUIRE(std::string((const char*)tree.getRoot(), 16) == nodeDigest(0, ""));
+
+    // One chunk is its own root
+    tree.build(text.data(), 10);
+    REQUIRE(std::string((const char*)tree.getRoot(), 16) == l0);
+
+    REQUIRE_THROWS_AS(MerkleTree<>(pool, 0), std::invalid_argument);
+}
+
+TEST_CASE("VerifyUpdate") {
+    ThreadPool pool(3);
+    for (SizeType len : {64, 1000, 4097, 20000}) {
+        std::string text = randomText(len);
+        MerkleTree<> tree(pool, 64);
+        tree.build(text.data(), text.size());
+        REQUIRE(tree.verify(text.data(), text.size()).empty());
+
+        // Change a few bytes and find their chunks
+        std::string changed = text;
+        std::vector<SizeType> expect;
+        for (SizeType pos : {len / 3, len / 2, len - 1}) {
+            changed[pos] = (char)~changed[pos];
+            expect.push_back(pos / 64);
+        }
+        std::sort(expect.begin(), expect.end());
+        expect.erase(std::unique(expect.begin(), expect.end()), expect.end());
+        REQUIRE(tree.verify(changed.data(), changed.size()) == expect);
+
+        // Rehashing the changed chunks gives the root of a full build
+        MerkleTree<> rebuilt(pool, 64);
+        rebuilt.build(changed.data(), changed.size());
+        REQUIRE(tree.getRootHex() != rebuilt.getRootHex());
+        tree.update(changed.data(), changed.size(), expect);
+        REQUIRE(tree.getRootHex() == rebuilt.getRootHex());
+        REQUIRE(tree.verify(changed.data(), changed.size()).empty());
+    }
+
+    MerkleTree<> tree(pool, 64);
+    std::string text = randomText(100);
+    tree.build(text.data(), text.size());
+    REQUIRE_THROWS_AS(tree.verify(text.data(), 99), std::invalid_argument);
+    REQUIRE_THROWS_AS(tree.update(text.data(), 100, {2}), std::invalid_argument);
+}
+
+TEST_CASE("Digests") {
+    ThreadPool pool(2);
+    std::string text = randomText(5000);
+    MerkleTree<jumble::SHA256Context> sha(pool, 512);
+    sha.build(text.data(), text.size());
+    REQUIRE(sha.getRootHex().size() == (SizeType)64);
+    MerkleTree<jumble::XXH64Context> xxh(pool, 512);
+    xxh.build(text.data(), text.size());
+    REQUIRE(xxh.getRootHex().size() == (SizeType)16);
+
+    text[4999] = 'x';
+    text[4998] = 'y';
+    REQUIRE(sha.verify(text.data(), text.size()) == std::vector<SizeType>{9});
+    REQUIRE(xxh.verify(text.data(), text.size()) == std::vector<SizeType>{9});
+}
+
+TEST_CASE("File") {
+    const char *path = "test_merkle_tree.bin";
+    std::string text = randomText(3000);
+    {
+        std::ofstream ofs(path, std::ios::binary);
+        ofs << text;
+    }
+    ThreadPool pool(2);
+    MerkleTree<> tree(pool, 1000), expect(pool, 1000);
+    tree.buildFile(path);
+    expect.build(text.data(), text.size());
+    REQUIRE(tree.getRootHex() == expect.getRootHex());
+    REQUIRE(tree.verifyFile(path).empty());
+    std::remove(path);
+    REQUIRE_THROWS_AS(tree.buildFile(path), std::runtime_error);
+}
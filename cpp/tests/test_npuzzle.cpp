@@ -1,5 +1,11 @@
 #include "catch2/catch_amalgamated.hpp"
 #include "jumble/npuzzle.hpp"
+#include <string>
+#include <vector>
+#include <stdexcept>
+#include <deque>
+#include <unordered_map>
+#include <cstdint>
 
 using jumble::PuzzleNode;
 using jumble::NPuzzle;
@@ -7,6 +13,30 @@ using jumble::Direc;
 
 typedef PuzzleNode::SizeType SizeType;
 
+// Return the length of the shortest path between two nodes by BFS
+static SizeType bfsDistance(const PuzzleNode& beg, const PuzzleNode& end) {
+    std::unordered_map<std::uint64_t, SizeType> dist = {{beg.hash(), 0}};
+    std::deque<PuzzleNode> queue = {beg};
+    while (!queue.empty()) {
+        PuzzleNode cur = queue.front();
+        queue.pop_front();
+        SizeType d = dist[cur.hash()];
+        if (cur == end) {
+            return d;
+        }
+        for (int i = 1; i < 5; ++i) {
+            if (cur.canMove(Direc(i))) {
+                PuzzleNode adj = cur;
+                adj.move(Direc(i));
+                if (dist.emplace(adj.hash(), d + 1).second) {
+                    queue.push_back(adj);
+                }
+            }
+        }
+    }
+    return 0;
+}
+
 TEST_CASE("Node") {
     PuzzleNode oriNode({1, 2, 3, 4, 0, 5, 6, 7, 8}, 3, 3);
     PuzzleNode node({1, 2, 3, 4, 0, 5, 6, 7, 8}, 3, 3);
@@ -96,4 +126,217 @@ TEST_CASE("AStar") {
         beg.move(d);
     }
     REQUIRE(beg == end);
+    REQUIRE(path.size() == bfsDistance(puzzle.getBeg(), end));
+}
+
+TEST_CASE("Packed") {
+    REQUIRE(sizeof(PuzzleNode) <= 48);
+    REQUIRE(NPuzzle::getSearchNodeSize() <= 48);
+    REQUIRE_THROWS_AS(PuzzleNode({1, 2, 3, 0}, 2, 3), std::invalid_argument);
+    REQUIRE_THROWS_AS(PuzzleNode({1, 2, 3, 4}, 2, 2), std::invalid_argument);
+    REQUIRE_THROWS_AS(PuzzleNode({-1, 2, 3, 0}, 2, 2), std::invalid_argument);
+    REQUIRE_THROWS_AS(PuzzleNode({1, 1, 3, 0}, 2, 2), std::invalid_argument);
+    REQUIRE_THROWS_AS(PuzzleNode({0, 2, 3, 0}, 2, 2), std::invalid_argument);
+    REQUIRE_THROWS_AS(PuzzleNode(std::vector<int>(36, 0), 6, 6), std::invalid_argument);
+
+    std::vector<int> val(25);
+    for (int i = 0; i < 25; ++i) {
+        val[i] = (i + 1) % 25;
+    }
+    PuzzleNode oriNode(val, 5, 5);
+    PuzzleNode node(val, 5, 5);
+    REQUIRE(node.toString() == "{1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, "
+                               "16, 17, 18, 19, 20, 21, 22, 23, 24, 0}");
+    REQUIRE(!node.canMove(Direc::RIGHT));
+    REQUIRE(!node.canMove(Direc::DOWN));
+
+    node.move(Direc::UP);
+    node.move(Direc::LEFT);
+    REQUIRE(node.toString() == "{1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, "
+                               "16, 17, 18, 0, 19, 21, 22, 23, 24, 20}");
+    REQUIRE(!(node == oriNode));
+    node.move(Direc::RIGHT);
+    node.move(Direc::DOWN);
+    REQUIRE(node == oriNode);
+
+    node.shuffle();
+    std::string str = node.toString();
+    for (int i = 0; i < 25; ++i) {
+        REQUIRE(str.find(std::to_string(i)) != std::string::npos);
+    }
+}
+
+TEST_CASE("Hash") {
+    PuzzleNode node({1, 2, 3, 4, 0, 5, 6, 7, 8}, 3, 3);
+    PuzzleNode other({1, 2, 3, 4, 5, 0, 6, 7, 8}, 3, 3);
+    REQUIRE(node.hash() != other.hash());
+
+    // Hash values are updated incrementally along any path
+    node.move(Direc::UP);
+    node.move(Direc::RIGHT);
+    node.move(Direc::DOWN);
+    REQUIRE(node.toString() == "{1, 3, 5, 4, 2, 0, 6, 7, 8}");
+    REQUIRE(node.hash() == PuzzleNode({1, 3, 5, 4, 2, 0, 6, 7, 8}, 3, 3).hash());
+    node.move(Direc::LEFT);
+    node.move(Direc::UP);
+    node.move(Direc::RIGHT);
+    node.move(Direc::DOWN);
+    REQUIRE(node.toString() == "{1, 5, 2, 4, 3, 0, 6, 7, 8}");
+    REQUIRE(node.hash() == PuzzleNode({1, 5, 2, 4, 3, 0, 6, 7, 8}, 3, 3).hash());
+}
+
+TEST_CASE("IDAStar") {
+    PuzzleNode beg({0, 1, 2, 3, 4, 5, 6, 7, 8}, 3, 3);
+    PuzzleNode end({0, 1, 2, 3, 4, 5, 6, 7, 8}, 3, 3);
+    NPuzzle puzzle(beg, end);
+    puzzle.solveIDAStar();
+    REQUIRE(puzzle.getPath().empty());
+    REQUIRE(puzzle.getSearchCount() == (SizeType)1);
+
+    for (int t = 0; t < 5; ++t) {
+        beg.shuffle();
+        end.shuffle();
+        puzzle.setBeg(beg);
+        puzzle.setEnd(end);
+        puzzle.solve();
+        SizeType length = puzzle.getPath().size();
+        puzzle.solveIDAStar();
+        const auto &path = puzzle.getPath();
+        REQUIRE(path.size() == length);
+        REQUIRE(path.size() == bfsDistance(beg, end));
+        PuzzleNode node = beg;
+        for (const auto &d : path) {
+            REQUIRE(node.canMove(d));
+            node.move(d);
+        }
+        REQUIRE(node == end);
+    }
+
+    // Unreachable with two numbers swapped
+    puzzle.setBeg(PuzzleNode({1, 0, 2, 3, 4, 5, 6, 7, 8}, 3, 3));
+    puzzle.setEnd(PuzzleNode({0, 2, 1, 3, 4, 5, 6, 7, 8}, 3, 3));
+    puzzle.solveIDAStar();
+    REQUIRE(puzzle.getPath().empty());
+    REQUIRE(puzzle.getSearchCount() == (SizeType)0);
+    puzzle.setBeg(PuzzleNode({1, 0, 2, 3}, 1, 4));
+    puzzle.setEnd(PuzzleNode({2, 1, 0, 3}, 1, 4));
+    puzzle.solveIDAStar();
+    REQUIRE(puzzle.getPath().empty());
+    puzzle.setEnd(PuzzleNode({1, 2, 3, 0}, 1, 4));
+    puzzle.solveIDAStar();
+    REQUIRE(puzzle.getPath().size() == (SizeType)2);
+}
+
+TEST_CASE("HDAStar") {
+    PuzzleNode beg({0, 1, 2, 3, 4, 5, 6, 7, 8}, 3, 3);
+    PuzzleNode end({0, 1, 2, 3, 4, 5, 6, 7, 8}, 3, 3);
+    NPuzzle puzzle(beg, end);
+    puzzle.solveHDAStar(2);
+    REQUIRE(puzzle.getPath().empty());
+    REQUIRE(puzzle.getSearchCount() == (SizeType)1);
+
+    for (int t = 0; t < 4; ++t) {
+        beg.shuffle();
+        end.shuffle();
+        puzzle.setBeg(beg);
+        puzzle.setEnd(end);
+        SizeType length = bfsDistance(beg, end);
+        for (SizeType threads : {1, 2, 4}) {
+            puzzle.solveHDAStar(threads);
+            const auto &path = puzzle.getPath();
+            REQUIRE(path.size() == length);
+            PuzzleNode node = beg;
+            for (const auto &d : path) {
+                REQUIRE(node.canMove(d));
+                node.move(d);
+            }
+            REQUIRE(node == end);
+        }
+    }
+
+    puzzle.setBeg(PuzzleNode({1, 0, 2, 3, 4, 5, 6, 7, 8}, 3, 3));
+    puzzle.setEnd(PuzzleNode({0, 2, 1, 3, 4, 5, 6, 7, 8}, 3, 3));
+    puzzle.solveHDAStar(3);
+    REQUIRE(puzzle.getPath().empty());
+}
+
+TEST_CASE("Reuse") {
+    PuzzleNode beg({0, 1, 2, 3, 4, 5, 6, 7, 8}, 3, 3);
+    PuzzleNode end({0, 1, 2, 3, 4, 5, 6, 7, 8}, 3, 3);
+    NPuzzle puzzle(beg, end);
+    for (int t = 0; t < 5; ++t) {
+        beg.shuffle();
+        puzzle.setBeg(beg);
+        puzzle.solve();
+        SizeType length = puzzle.getPath().size();
+        REQUIRE(length == bfsDistance(beg, end));
+        puzzle.solve();
+        REQUIRE(puzzle.getPath().size() == length);
+        PuzzleNode node = beg;
+        for (const auto &d : puzzle.getPath()) {
+            node.move(d);
+        }
+        REQUIRE(node == end);
+    }
+}
+
+TEST_CASE("BucketOpenList") {
+    PuzzleNode beg({0, 1, 2, 3, 4, 5, 6, 7, 8}, 3, 3);
+    PuzzleNode end({0, 1, 2, 3, 4, 5, 6, 7, 8}, 3, 3);
+    NPuzzle puzzle(beg, end);
+    puzzle.setOpenListType(NPuzzle::BUCKET);
+    for (int t = 0; t < 5; ++t) {
+        beg.shuffle();
+        puzzle.setBeg(beg);
+        puzzle.solve();
+        REQUIRE(puzzle.getPath().size() == bfsDistance(beg, end));
+        PuzzleNode node = beg;
+        for (const auto &d : puzzle.getPath()) {
+            node.move(d);
+        }
+        REQUIRE(node == end);
+    }
+}
+
+TEST_CASE("Stats") {
+    PuzzleNode beg({8, 6, 7, 2, 5, 4, 3, 0, 1}, 3, 3);
+    PuzzleNode end({1, 2, 3, 4, 5, 6, 7, 8, 0}, 3, 3);
+    NPuzzle puzzle(beg, end);
+    SizeType calls = 0, last = 0;
+    puzzle.setProgress([&calls, &last](const NPuzzle::Stats& s) {
+        REQUIRE(s.expansions == last + 100);
+        last = s.expansions;
+        ++calls;
+    }, 100);
+
+    for (auto t : {NPuzzle::HEAP, NPuzzle::BUCKET}) {
+        calls = last = 0;
+        puzzle.setOpenListType(t);
+        puzzle.solve();
+        REQUIRE(puzzle.getPath().size() == (SizeType)31);
+        const auto &stats = puzzle.getStats();
+        REQUIRE(stats.expansions == puzzle.getSearchCount());
+        REQUIRE(calls == (stats.expansions - 1) / 100);
+        REQUIRE(stats.generations > stats.duplicates);
+        REQUIRE(stats.openPushes == stats.generations - stats.duplicates + 1);
+        REQUIRE(stats.openPops <= stats.openPushes);
+        REQUIRE(stats.openPops >= stats.expansions);
+        REQUIRE(stats.peakOpen > (SizeType)0);
+        REQUIRE(stats.peakClosed >= stats.expansions);
+        REQUIRE(stats.peakClosed <= stats.openPushes);
+        REQUIRE(stats.allocatedBytes > (SizeType)0);
+        REQUIRE(stats.peakBytes >= stats.allocatedBytes);
+        REQUIRE(stats.duplicateRate() > 0);
+        REQUIRE(stats.duplicateRate() < 1);
+    }
+
+    // No progress report
+    puzzle.setProgress(nullptr, 100);
+    calls = 0;
+    puzzle.solve();
+    REQUIRE(calls == (SizeType)0);
+
+    puzzle.solveIDAStar();
+    REQUIRE(puzzle.getStats().expansions == puzzle.getSearchCount());
+    REQUIRE(puzzle.getStats().generations == (SizeType)0);
 }
@@ -0,0 +1,123 @@
+#include "catch2/catch_amalgamated.hpp"
+#include "jumble/npuzzle_batch.hpp"
+#include "jumble/pattern_database.hpp"
+#include <vector>
+#include <atomic>
+#include <future>
+#include <mutex>
+#include <list>
+#include <cstdint>
+
+using jumble::PuzzleNode;
+using jumble::NPuzzle;
+using jumble::NPuzzleBatch;
+using jumble::PatternDatabase;
+using jumble::ThreadPool;
+using jumble::Direc;
+
+typedef PuzzleNode::SizeType SizeType;
+
+// Return a node reached by moving the empty grid randomly from 'node'
+static PuzzleNode scramble(PuzzleNode node, const int moves) {
+    for (int i = 0; i < moves; ++i) {
+        Direc d = Direc(jumble::Random::getInstance()->nextInt(1, 4));
+        if (node.canMove(d)) {
+            node.move(d);
+        }
+    }
+    return node;
+}
+
+// Check that a path leads from the beginning node to the ending node
+static bool isValidPath(PuzzleNode beg, const PuzzleNode& end, const std::list<Direc>& path) {
+    for (const auto &d : path) {
+        if (!beg.canMove(d)) {
+            return false;
+        }
+        beg.move(d);
+    }
+    return beg == end;
+}
+
+TEST_CASE("WorkStealing") {
+    ThreadPool pool(4);
+    REQUIRE(pool.getWorkerIndex() == pool.getSize());
+    std::atomic<int> sum(0);
+    std::atomic<int> bad(0);
+    std::mutex mtx;
+    std::vector<std::future<void>> nested;
+    std::vector<std::future<void>> futures;
+    for (int i = 0; i < 1000; ++i) {
+        futures.push_back(pool.submit([&, i] {
+            if (pool.getWorkerIndex() >= pool.getSize()) {
+                ++bad;
+            }
+            // Tasks submitted by a worker go to its own queue
+            auto fut = pool.submit([&, i] {
+                sum += i;
+            });
+            std::lock_guard<std::mutex> lock(mtx);
+            nested.push_back(std::move(fut));
+        }));
+    }
+    for (auto &fut : futures) {
+        fut.get();
+    }
+    for (auto &fut : nested) {
+        fut.get();
+    }
+    REQUIRE(bad == 0);
+    REQUIRE(sum == 999 * 1000 / 2);
+}
+
+TEST_CASE("Batch") {
+    PuzzleNode goal({1, 2, 3, 4, 5, 6, 7, 8, 0}, 3, 3);
+    std::vector<NPuzzleBatch::Instance> instances;
+    for (int i = 0; i < 30; ++i) {
+        instances.emplace_back(scramble(goal, 1000), scramble(goal, 1000));
+    }
+    // Unreachable with two numbers swapped
+    instances.emplace_back(PuzzleNode({2, 1, 3, 4, 5, 6, 7, 8, 0}, 3, 3), goal);
+
+    ThreadPool pool(4);
+    for (auto algo : {NPuzzleBatch::ASTAR, NPuzzleBatch::IDA_STAR}) {
+        NPuzzleBatch batch(pool, algo);
+        for (int round = 0; round < 2; ++round) {
+            auto results = batch.solve(instances);
+            REQUIRE(results.size() == instances.size());
+            std::uint64_t expansions = 0;
+            for (SizeType i = 0; i + 1 < instances.size(); ++i) {
+                NPuzzle puzzle(instances[i].first, instances[i].second);
+                puzzle.solve();
+                REQUIRE(results[i].path.size() == puzzle.getPath().size());
+                REQUIRE(isValidPath(instances[i].first, instances[i].second, results[i].path));
+                REQUIRE(results[i].seconds >= 0);
+                expansions += results[i].searchCount;
+            }
+            REQUIRE(results.back().path.empty());
+            REQUIRE(batch.getStats().instances == instances.size());
+            REQUIRE(batch.getStats().expansions == expansions + results.back().searchCount);
+            REQUIRE(batch.getStats().expansionsPerSecond() > 0);
+        }
+    }
+}
+
+TEST_CASE("BatchHeuristic") {
+    PuzzleNode goal({0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15}, 4, 4);
+    PatternDatabase db(goal, {{1, 2, 3}, {4, 5, 6}, {7, 8, 9}, {10, 11, 12}, {13, 14, 15}});
+    std::vector<NPuzzleBatch::Instance> instances;
+    for (int i = 0; i < 8; ++i) {
+        instances.emplace_back(scramble(goal, 40), goal);
+    }
+
+    ThreadPool pool(3);
+    NPuzzleBatch batch(pool, NPuzzleBatch::IDA_STAR);
+    auto plain = batch.solve(instances);
+    batch.setHeuristic(db);
+    auto results = batch.solve(instances);
+    for (SizeType i = 0; i < instances.size(); ++i) {
+        REQUIRE(results[i].path.size() == plain[i].path.size());
+        REQUIRE(results[i].searchCount <= plain[i].searchCount);
+        REQUIRE(isValidPath(instances[i].first, goal, results[i].path));
+    }
+}
@@ -0,0 +1,138 @@
+#include "catch2/catch_amalgamated.hpp"
+#include "jumble/pattern_database.hpp"
+#include <string>
+#include <vector>
+#include <deque>
+#include <unordered_map>
+#include <cstdio>
+#include <cstdint>
+
+using jumble::PuzzleNode;
+using jumble::NPuzzle;
+using jumble::PatternDatabase;
+using jumble::Direc;
+
+typedef PuzzleNode::SizeType SizeType;
+
+static const char *PATH = "test_pattern_database.bin";
+
+// Return the distance of every node reachable from 'goal' by BFS
+static std::unordered_map<std::uint64_t, SizeType> bfsAll(const PuzzleNode& goal,
+                                                         std::vector<PuzzleNode>& nodes) {
+    std::unordered_map<std::uint64_t, SizeType> dist = {{goal.hash(), 0}};
+    std::deque<PuzzleNode> queue = {goal};
+    while (!queue.empty()) {
+        PuzzleNode cur = queue.front();
+        queue.pop_front();
+        nodes.push_back(cur);
+        SizeType d = dist[cur.hash()];
+        for (int i = 1; i < 5; ++i) {
+            if (cur.canMove(Direc(i))) {
+                PuzzleNode adj = cur;
+                adj.move(Direc(i));
+                if (dist.emplace(adj.hash(), d + 1).second) {
+                    queue.push_back(adj);
+                }
+            }
+        }
+    }
+    return dist;
+}
+
+TEST_CASE("Admissible") {
+    PuzzleNode goal({1, 2, 3, 4, 5, 6, 7, 8, 0}, 3, 3);
+    PatternDatabase db(goal, {{1, 2, 3, 4}, {5, 6, 7, 8}});
+    REQUIRE(db.getGroupCount() == (SizeType)2);
+    REQUIRE(db(goal) == (SizeType)0);
+    REQUIRE(db.getGoal() == goal);
+
+    std::vector<PuzzleNode> nodes;
+    auto dist = bfsAll(goal, nodes);
+    REQUIRE(nodes.size() == (SizeType)181440);
+    SizeType sumPattern = 0, sumConflict = 0, sumManhattan = 0;
+    for (const auto &node : nodes) {
+        SizeType d = dist[node.hash()];
+        REQUIRE(db.getPatternDistance(node) <= d);
+        REQUIRE(db.getLinearConflictDistance(node) <= d);
+        sumPattern += db.getPatternDistance(node);
+        sumConflict += db.getLinearConflictDistance(node);
+        for (SizeType i = 0; i < 9; ++i) {
+            SizeType num = node.getNum(i);
+            if (num) {
+                SizeType r = i / 3, c = i % 3, gr = (num - 1) / 3, gc = (num - 1) % 3;
+                sumManhattan += (r > gr ? r - gr : gr - r) + (c > gc ? c - gc : gc - c);
+            }
+        }
+    }
+    REQUIRE(sumConflict > sumManhattan);
+    REQUIRE(sumPattern > sumManhattan);
+}
+
+TEST_CASE("Solve") {
+    PuzzleNode goal({0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15}, 4, 4);
+    PatternDatabase db(goal, {{1, 2, 3}, {4, 5, 6}, {7, 8, 9}, {10, 11, 12}, {13, 14, 15}});
+
+    for (int t = 0; t < 3; ++t) {
+        PuzzleNode beg = goal;
+        for (int i = 0; i < 40; ++i) {
+            Direc d = Direc(jumble::Random::getInstance()->nextInt(1, 4));
+            if (beg.canMove(d)) {
+                beg.move(d);
+            }
+        }
+        NPuzzle puzzle(beg, goal);
+        puzzle.solve();
+        SizeType length = puzzle.getPath().size();
+        SizeType count = puzzle.getSearchCount();
+
+        puzzle.setHeuristic(db);
+        puzzle.solve();
+        REQUIRE(puzzle.getPath().size() == length);
+        REQUIRE(puzzle.getSearchCount() <= count);
+        puzzle.solveIDAStar();
+        REQUIRE(puzzle.getPath().size() == length);
+        puzzle.solveHDAStar(3);
+        REQUIRE(puzzle.getPath().size() == length);
+        for (const auto &d : puzzle.getPath()) {
+            beg.move(d);
+        }
+        REQUIRE(beg == goal);
+    }
+}
+
+TEST_CASE("File") {
+    PuzzleNode goal({1, 2, 3, 4, 5, 6, 7, 8, 0}, 3, 3);
+    PatternDatabase db(goal, {{1, 2, 4, 5}, {3, 6}, {7, 8}});
+    db.write(PATH);
+
+    PatternDatabase mapped(PATH);
+    REQUIRE(mapped.getGoal() == goal);
+    REQUIRE(mapped.getGroupCount() == (SizeType)3);
+    PuzzleNode node = goal;
+    for (int i = 0; i < 200; ++i) {
+        Direc d = Direc(jumble::Random::getInstance()->nextInt(1, 4));
+        if (node.canMove(d)) {
+            node.move(d);
+        }
+        REQUIRE(mapped.getPatternDistance(node) == db.getPatternDistance(node));
+        REQUIRE(mapped(node) == db(node));
+    }
+    std::remove(PATH);
+
+    REQUIRE_THROWS_AS(PatternDatabase(PATH), std::runtime_error);
+    FILE *f = std::fopen(PATH, "wb");
+    std::fputs("not a pattern database, but long enough to hold a header of ninety-six bytes...", f);
+    std::fputs("................", f);
+    std::fclose(f);
+    REQUIRE_THROWS_AS(PatternDatabase(PATH), std::runtime_error);
+    std::remove(PATH);
+}
+
+TEST_CASE("InvalidGroups") {
+    PuzzleNode goal({1, 2, 3, 4, 5, 6, 7, 8, 0}, 3, 3);
+    typedef PatternDatabase::Groups Groups;
+    REQUIRE_THROWS_AS(PatternDatabase(goal, Groups{{1, 2}, {}}), std::invalid_argument);
+    REQUIRE_THROWS_AS(PatternDatabase(goal, Groups{{0, 1}}), std::invalid_argument);
+    REQUIRE_THROWS_AS(PatternDatabase(goal, Groups{{1, 9}}), std::invalid_argument);
+    REQUIRE_THROWS_AS(PatternDatabase(goal, Groups{{1, 2}, {2, 3}}), std::invalid_argument);
+}
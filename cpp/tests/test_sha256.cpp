@@ -0,0 +1,82 @@
+#include "catch2/catch_amalgamated.hpp"
+#include "jumble/sha256.hpp"
+#include "jumble/util/random.hpp"
+#include <string>
+#include <vector>
+#include <stdexcept>
+#include <cstddef>
+
+using jumble::SHA256;
+using jumble::SHA256Context;
+
+static const SHA256Context::Kernel KERNELS[] = {SHA256Context::PORTABLE, SHA256Context::SHANI};
+
+TEST_CASE("Kernels") {
+    REQUIRE(SHA256Context::isSupported(SHA256Context::PORTABLE));
+    REQUIRE(SHA256Context().getKernel() == SHA256Context::getBestKernel());
+    for (auto k : KERNELS) {
+        if (!SHA256Context::isSupported(k)) {
+            REQUIRE_THROWS_AS(SHA256Context(k), std::invalid_argument);
+        }
+    }
+}
+
+TEST_CASE("Known") {
+    std::string million(1000000, 'a');
+    std::string binary;
+    for (int i = 0; i < 1000; ++i) {
+        binary += (char)(i % 256);
+    }
+    for (auto k : KERNELS) {
+        if (!SHA256Context::isSupported(k)) {
+            continue;
+        }
+        SHA256Context ctx(k);
+        REQUIRE(ctx.finalize() == "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855");
+        ctx.update("abc", 3);
+        REQUIRE(ctx.finalize() == "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad");
+        ctx.update("The quick brown fox jumps over the lazy dog", 43);
+        REQUIRE(ctx.finalize() == "d7a8fbb307d7809469ca9abcb0082e4f8d5651e46d3cdb762d02d0bf37c9e592");
+        ctx.update(binary.data(), binary.size());
+        REQUIRE(ctx.finalize() == "a8af099bf2e878609558dbf69d8f88f4a31040a8cf84b549a0cfa912f12ffc3f");
+        ctx.update(million.data(), million.size());
+        REQUIRE(ctx.finalize() == "cdc76e5c9914fb9281a1c7e284d73e67f1809a48a497200e046d39ccc7112cd0");
+    }
+    REQUIRE(SHA256::hash("abc") == "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad");
+}
+
+TEST_CASE("Streaming") {
+    auto random = jumble::Random::getInstance();
+    std::string text;
+    for (int i = 0; i < 300; ++i) {
+        text += (char)random->nextInt(0, 255);
+    }
+    for (auto k : KERNELS) {
+        if (!SHA256Context::isSupported(k)) {
+            continue;
+        }
+        SHA256Context ctx(k);
+        // Every split of messages around the padding boundaries
+        for (std::size_t len = 50; len < 140; ++len) {
+            std::string expect = SHA256::hash(text.substr(0, len));
+            for (std::size_t i = 0; i <= len; ++i) {
+                ctx.update(text.data(), i);
+                ctx.update(text.data() + i, len - i);
+                REQUIRE(ctx.finalize() == expect);
+            }
+        }
+        // Many blocks in one call
+        SHA256Context portable(SHA256Context::PORTABLE);
+        portable.update(text.data(), text.size());
+        ctx.update(text.data(), text.size());
+        REQUIRE(ctx.finalize() == portable.finalize());
+    }
+}
+
+TEST_CASE("RawDigest") {
+    unsigned char digest[SHA256Context::DIGEST_SIZE];
+    SHA256::hash("abc", 3, digest);
+    REQUIRE(digest[0] == 0xba);
+    REQUIRE(digest[31] == 0xad);
+    REQUIRE(SHA256Context::toHex(digest) == SHA256::hash("abc", 3));
+}
@@ -0,0 +1,74 @@
+#include "catch2/catch_amalgamated.hpp"
+#include "jumble/xxhash.hpp"
+#include <string>
+#include <vector>
+#include <set>
+#include <cstddef>
+#include <cstdint>
+
+using jumble::XXH64;
+using jumble::XXH64Context;
+
+TEST_CASE("Known") {
+    REQUIRE(XXH64::hash("", 0) == 0xef46db3751d8e999ULL);
+    REQUIRE(XXH64::hash("a", 1) == 0xd24ec4f1a98c6e5bULL);
+    REQUIRE(XXH64::hash("abc", 3) == 0x44bc2cf5ad770999ULL);
+    REQUIRE(XXH64::hash("Nobody inspects the spammish repetition", 39) == 0xfbcea83c8a378bf1ULL);
+
+    std::string binary;
+    for (int i = 0; i < 1000; ++i) {
+        binary += (char)(i % 256);
+    }
+    REQUIRE(XXH64::hash(binary.data(), binary.size()) == 0x6ef436b00eba4078ULL);
+    std::string million(1000000, 'a');
+    REQUIRE(XXH64::hash(million.data(), million.size()) == 0xdc483aaa9b4fdc40ULL);
+}
+
+TEST_CASE("Seed") {
+    REQUIRE(XXH64::hash("", 0, 1) == 0xd5afba1336a3be4bULL);
+    REQUIRE(XXH64::hash("abc", 3, 0x9e3779b97f4a7c15ULL) == 0x2ed0f59d6b43ac8bULL);
+
+    XXH64Context ctx(1);
+    REQUIRE(ctx.getValue() == 0xd5afba1336a3be4bULL);
+    ctx.reset(0);
+    REQUIRE(ctx.getValue() == 0xef46db3751d8e999ULL);
+}
+
+TEST_CASE("Streaming") {
+    XXH64Context ctx;
+    REQUIRE(ctx.finalize() == "ef46db3751d8e999");
+    ctx.update("abc", 3);
+    unsigned char digest[XXH64Context::DIGEST_SIZE];
+    ctx.finalize(digest);
+    REQUIRE(digest[0] == 0x44);
+    REQUIRE(digest[7] == 0x99);
+
+    // Every split of messages around the stripe boundaries
+    std::string text;
+    for (int i = 0; i < 100; ++i) {
+        text += (char)(i * 37);
+    }
+    for (std::size_t len = 0; len < text.size(); ++len) {
+        std::uint64_t expect = XXH64::hash(text.data(), len);
+        for (std::size_t i = 0; i <= len; ++i) {
+            ctx.update(text.data(), i);
+            REQUIRE(ctx.getValue() == XXH64::hash(text.data(), i));
+            ctx.update(text.data() + i, len - i);
+            REQUIRE(ctx.getValue() == expect);
+            ctx.reset();
+        }
+    }
+}
+
+TEST_CASE("FastHash") {
+    jumble::FastHash<std::string> strHash;
+    REQUIRE(strHash("abc") == (std::size_t)XXH64::hash("abc", 3));
+
+    // Multiples of 1024 spread over the low bits used by power-of-two tables
+    jumble::FastHash<std::uint64_t> intHash;
+    std::set<std::size_t> buckets;
+    for (std::uint64_t i = 0; i < 1024; ++i) {
+        buckets.insert(intHash(i << 10) & 1023);
+    }
+    REQUIRE(buckets.size() > (std::size_t)600);
+}